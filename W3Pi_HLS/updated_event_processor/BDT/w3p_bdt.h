@@ -3,6 +3,7 @@
 
 #include "BDT_new.h"
 #include "ap_fixed.h"
+#include "../src/native_types.h"
 
 namespace w3p_bdt {
     static const int n_trees = 10;
@@ -10,10 +11,10 @@ namespace w3p_bdt {
     static const int n_classes = 2;
     static const int n_features = 11;
     static const bool unroll = true;
-    typedef ap_fixed<19,8,AP_RND_CONV,AP_SAT> input_t;
+    typedef arith::ap_fixed<19,8,AP_RND_CONV,AP_SAT> input_t;
     typedef input_t input_arr_t[n_features];
-    typedef ap_fixed<19,8,AP_RND_CONV,AP_SAT> threshold_t;
-    typedef ap_fixed<11,4,AP_RND_CONV,AP_SAT> score_t;
+    typedef arith::ap_fixed<19,8,AP_RND_CONV,AP_SAT> threshold_t;
+    typedef arith::ap_fixed<11,4,AP_RND_CONV,AP_SAT> score_t;
     typedef score_t score_arr_t[n_classes];
     typedef float accelerator_input_t;
     typedef float accelerator_output_t;
@@ -45,88 +45,16 @@ bool puppiComparator (Puppi a, Puppi b)
     return (a.hwPt > b.hwPt);
 }
 
-// Split and order 16 arrays of 13 candidates (16 x 13 = 208)
-void orderer7_ref (const Puppi slimmed[NPUPPI_MAX],
-                   Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                   Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                   Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                   Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-                   Puppi ordered9 [NSPLITS], Puppi ordered10[NSPLITS],
-                   Puppi ordered11[NSPLITS], Puppi ordered12[NSPLITS],
-                   Puppi ordered13[NSPLITS], Puppi ordered14[NSPLITS],
-                   Puppi ordered15[NSPLITS], Puppi ordered16[NSPLITS])
+// Split in consecutive arrays of nsplit candidates (e.g. 16 x 13, 8 x 26 or 4 x 52 = 208)
+// and order each of them; ordered[k*nsplit + i] is element i of array k
+void orderer_ref (const Puppi slimmed[NPUPPI_MAX], unsigned int nsplit, Puppi ordered[NPUPPI_MAX])
 {
-    // Split in 16 arrays
-    for (unsigned int i=0; i < NSPLITS; i++)
-    {
-        #pragma HLS UNROLL
-        ordered1 [i] = slimmed[i];
-        ordered2 [i] = slimmed[i+NSPLITS];
-        ordered3 [i] = slimmed[i+2*NSPLITS];
-        ordered4 [i] = slimmed[i+3*NSPLITS];
-        ordered5 [i] = slimmed[i+4*NSPLITS];
-        ordered6 [i] = slimmed[i+5*NSPLITS];
-        ordered7 [i] = slimmed[i+6*NSPLITS];
-        ordered8 [i] = slimmed[i+7*NSPLITS];
-        ordered9 [i] = slimmed[i+8*NSPLITS];
-        ordered10[i] = slimmed[i+9*NSPLITS];
-        ordered11[i] = slimmed[i+10*NSPLITS];
-        ordered12[i] = slimmed[i+11*NSPLITS];
-        ordered13[i] = slimmed[i+12*NSPLITS];
-        ordered14[i] = slimmed[i+13*NSPLITS];
-        ordered15[i] = slimmed[i+14*NSPLITS];
-        ordered16[i] = slimmed[i+15*NSPLITS];
-    }
-
-    // Sort arrays
-    std::stable_sort(ordered1 , ordered1  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered2 , ordered2  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered3 , ordered3  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered4 , ordered4  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered5 , ordered5  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered6 , ordered6  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered7 , ordered7  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered8 , ordered8  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered9 , ordered9  + NSPLITS, puppiComparator);
-    std::stable_sort(ordered10, ordered10 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered11, ordered11 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered12, ordered12 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered13, ordered13 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered14, ordered14 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered15, ordered15 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered16, ordered16 + NSPLITS, puppiComparator);
-}
-
-// Split and order 8 arrays of 26 candidates (8 x 26 = 208)
-void orderer7bis_ref (const Puppi slimmed[NPUPPI_MAX],
-                   Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                   Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                   Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                   Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS])
-{
-    // Split in 8 arrays
-    for (unsigned int i=0; i < NSPLITS; i++)
-    {
-        #pragma HLS UNROLL
-        ordered1[i] = slimmed[i];
-        ordered2[i] = slimmed[i+NSPLITS];
-        ordered3[i] = slimmed[i+2*NSPLITS];
-        ordered4[i] = slimmed[i+3*NSPLITS];
-        ordered5[i] = slimmed[i+4*NSPLITS];
-        ordered6[i] = slimmed[i+5*NSPLITS];
-        ordered7[i] = slimmed[i+6*NSPLITS];
-        ordered8[i] = slimmed[i+7*NSPLITS];
-    }
+    for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+        ordered[i] = slimmed[i];
 
     // Sort arrays
-    std::stable_sort(ordered1, ordered1 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered2, ordered2 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered3, ordered3 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered4, ordered4 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered5, ordered5 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered6, ordered6 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered7, ordered7 + NSPLITS, puppiComparator);
-    std::stable_sort(ordered8, ordered8 + NSPLITS, puppiComparator);
+    for (unsigned int k = 0; k + nsplit <= NPUPPI_MAX; k += nsplit)
+        std::stable_sort(ordered + k, ordered + k + nsplit, puppiComparator);
 }
 
 // ------------------------------------------------------------------
@@ -239,20 +167,38 @@ void get_triplet_inputs_ref (const Puppi selected[NPUPPI_SEL], idx_t idx0, idx_t
     BDT_inputs[10] = selected[idx2].hwEta;
 }
 
+// ------------------------------------------------------------------
+// Invariant mass and pT of a triplet, from the sum of the massless four-vectors
+void get_triplet_kinematics_ref (const Puppi selected[NPUPPI_SEL], idx_t idx0, idx_t idx1, idx_t idx2, double & mass, double & pt)
+{
+    double px = 0, py = 0, pz = 0, e = 0;
+    const idx_t idx[3] = {idx0, idx1, idx2};
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        const Puppi & p = selected[idx[i]];
+        px += p.floatPt() * std::cos(p.floatPhi());
+        py += p.floatPt() * std::sin(p.floatPhi());
+        pz += p.floatPt() * std::sinh(p.floatEta());
+        e  += p.floatPt() * std::cosh(p.floatEta());
+    }
+    mass = std::sqrt(std::max(0., e*e - px*px - py*py - pz*pz));
+    pt = std::sqrt(px*px + py*py);
+}
+
 // ------------------------------------------------------------------
 // Get all event inputs
 // - 8 triplets from: 5 from 1st+2nd, 2 from 1st+3rd and 1 from 2nd+3rd:
-// (0,1,2)-(0,1,3)-(0,1,4)-(0,1,5)-(0,1,6)-(0,2,3)-(0,2,3)-(1,2,3)
+// (0,1,2)-(0,1,3)-(0,1,4)-(0,1,5)-(0,1,6)-(0,2,3)-(0,2,4)-(1,2,3)
+static const idx_t REF_TRIPLETS[NTRIPLETS][3] = {
+    {0, 1, 2}, {0, 1, 3}, {0, 1, 4}, {0, 1, 5}, {0, 1, 6},
+    {0, 2, 3}, {0, 2, 4},
+    {1, 2, 3}
+};
+
 void get_event_inputs_ref (const Puppi selected[NPUPPI_SEL], w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features])
 {
-    get_triplet_inputs_ref(selected, 0, 1, 2, BDT_inputs[0]);
-    get_triplet_inputs_ref(selected, 0, 1, 3, BDT_inputs[1]);
-    get_triplet_inputs_ref(selected, 0, 1, 4, BDT_inputs[2]);
-    get_triplet_inputs_ref(selected, 0, 1, 5, BDT_inputs[3]);
-    get_triplet_inputs_ref(selected, 0, 1, 6, BDT_inputs[4]);
-    get_triplet_inputs_ref(selected, 0, 2, 3, BDT_inputs[5]);
-    get_triplet_inputs_ref(selected, 0, 2, 4, BDT_inputs[6]);
-    get_triplet_inputs_ref(selected, 1, 2, 3, BDT_inputs[7]);
+    for (unsigned int i = 0; i < NTRIPLETS; i++)
+        get_triplet_inputs_ref(selected, REF_TRIPLETS[i][0], REF_TRIPLETS[i][1], REF_TRIPLETS[i][2], BDT_inputs[i]);
 }
 
 // ------------------------------------------------------------------
@@ -273,12 +219,9 @@ std::vector<T> inputs_to_vec(T A[], int size)
 // from: https://github.com/cms-sw/cmssw/blob/master/L1Trigger/Phase2L1ParticleFlow/src/egamma/pftkegalgo_ref.cpp#L323-L325
 void get_event_scores_ref (w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features], w3p_bdt::score_t BDT_scores[NTRIPLETS])
 {
-    // Declare BDT
-    conifer::BDT<w3p_bdt::input_t, w3p_bdt::score_t, false> *composite_bdt_;
-
-    // Load model
-    std::string resolvedFileName = "conifer_binary_featV4_finalFit_v5.json";
-    composite_bdt_ = new conifer::BDT<w3p_bdt::input_t, w3p_bdt::score_t, false>(resolvedFileName);
+    // Load model only once (thread-safe static initialization, shared read-only by all callers)
+    static const std::string resolvedFileName = "conifer_binary_featV4_finalFit_v5.json";
+    static const conifer::BDT<w3p_bdt::input_t, w3p_bdt::score_t, false> composite_bdt(resolvedFileName);
 
     // Get score for each triplet
     for (unsigned int i = 0; i < NTRIPLETS; i++)
@@ -287,7 +230,7 @@ void get_event_scores_ref (w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_fea
         std::vector<w3p_bdt::input_t> triplet_vec_inputs = inputs_to_vec<w3p_bdt::input_t>(BDT_inputs[i], w3p_bdt::n_features);
 
         // Compure score
-        std::vector<w3p_bdt::score_t> bdt_score = composite_bdt_->decision_function(triplet_vec_inputs);
+        std::vector<w3p_bdt::score_t> bdt_score = composite_bdt.decision_function(triplet_vec_inputs);
 
         // Store score in output variable
         BDT_scores[i] = bdt_score.at(0);
@@ -306,8 +249,8 @@ void get_highest_score_ref (w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::sco
 }
 
 // ------------------------------------------------------------------
-// Full EventProcessor
-void EventProcessor_ref (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+// Selected candidates of the full EventProcessor
+static void select_ref (const Puppi input[NPUPPI_MAX], Puppi selected[NPUPPI_SEL])
 {
     // Mask candidates
     ap_uint<NPUPPI_MAX> masked;
@@ -324,8 +267,15 @@ void EventProcessor_ref (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_s
     merger_ref(slimmed, merged);
 
     // Select only highest pT ordered-candidates
-    Puppi selected[NPUPPI_SEL];
     selector_ref(merged, selected);
+}
+
+// ------------------------------------------------------------------
+// Full EventProcessor
+void EventProcessor_ref (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    Puppi selected[NPUPPI_SEL];
+    select_ref(input, selected);
 
     // Get inputs for each triplet
     w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
@@ -338,3 +288,41 @@ void EventProcessor_ref (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_s
     // Get highest BDT score among triplets
     get_highest_score_ref(BDT_scores, max_score);
 }
+
+// ------------------------------------------------------------------
+// Mass window decisions of the firmware triplets (TRIPLETS), from the float four-vectors:
+// in the window if distinct and TRIPLET_MASS_MIN <= m(3pi) <= TRIPLET_MASS_MAX
+void get_event_window_ref (const Puppi selected[NPUPPI_SEL], double mass[NTRIPLETS], bool in_window[NTRIPLETS])
+{
+    for (unsigned int i = 0; i < NTRIPLETS; i++)
+    {
+        double pt;
+        get_triplet_kinematics_ref(selected, TRIPLETS[i][0], TRIPLETS[i][1], TRIPLETS[i][2], mass[i], pt);
+        in_window[i] = distinct_triplet(i) && mass[i] >= TRIPLET_MASS_MIN && mass[i] <= TRIPLET_MASS_MAX;
+    }
+}
+
+// ------------------------------------------------------------------
+// Full EventProcessor on the firmware triplets (TRIPLETS), scoring only the ones in the mass
+// window (get_event_window_ref); the lowest score for the others, as EventProcessor7fVeto
+void EventProcessorVeto_ref (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    Puppi selected[NPUPPI_SEL];
+    select_ref(input, selected);
+
+    w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
+    for (unsigned int i = 0; i < NTRIPLETS; i++)
+        get_triplet_inputs_ref(selected, TRIPLETS[i][0], TRIPLETS[i][1], TRIPLETS[i][2], BDT_inputs[i]);
+
+    w3p_bdt::score_t BDT_scores[NTRIPLETS];
+    get_event_scores_ref(BDT_inputs, BDT_scores);
+
+    // Veto the triplets out of the mass window
+    double mass[NTRIPLETS];
+    bool in_window[NTRIPLETS];
+    get_event_window_ref(selected, mass, in_window);
+    for (unsigned int i = 0; i < NTRIPLETS; i++)
+        if (!in_window[i]) BDT_scores[i] = -(1 << (w3p_bdt::score_t::iwidth-1));
+
+    get_highest_score_ref(BDT_scores, max_score);
+}
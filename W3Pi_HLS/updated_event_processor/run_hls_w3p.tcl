@@ -4,26 +4,36 @@ open_project -reset "proj_v1"
 # Specify the name of the top function to synthetize
 #set_top masker
 #set_top slimmer
-#set_top orderer7
-#set_top orderer7bis
 #set_top orderer7f
-#set_top merger
-#set_top merger7bis
 #set_top merger7f
+#set_top merger7f_pruned
+#set_top sorter7f
 #set_top selector
+#set_top selector7f
+#set_top topk7f
+#set_top stream_selector7f
 #set_top get_cos_phi
 #set_top get_cosh_eta
 #set_top get_pair_mass
 #set_top get_triplet_inputs
 #set_top get_event_inputs
+#set_top get_event_kinematics
 #set_top get_event_scores
 #set_top get_highest_score
 #set_top EventProcessor
 #set_top EventProcessor7bis
+#set_top EventProcessor4x52
 set_top EventProcessor7f
+#set_top EventProcessor7fPayload
+#set_top EventProcessor7fPruned
+#set_top EventProcessor7fVeto
+#set_top EventProcessorTopK
+#set_top analysis_main
+#set_top analysis_main_stream
 
 # Load source code for synthesis
 add_files src/event_processor.cc
+add_files src/analysis_main.cc
 
 # Load source code for the testbench
 #  - add `-cflags "-DON_W3P"` to testbench --> not sure what for
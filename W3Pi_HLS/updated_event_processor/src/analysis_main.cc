@@ -0,0 +1,179 @@
+#include "analysis_main.h"
+
+// ------------------------------------------------------------------
+// Unpacker: read one event from the raw word stream
+//  - decode the header and check valid-header and error bits
+//  - unpack the npuppi candidates (one word per clock) and zero-pad to NPUPPI_MAX
+//  - all npuppi words are always consumed, so that the stream stays aligned on the next header
+void unpacker (hls::stream<word_t> & input, Puppi event[NPUPPI_MAX], hls::stream<word_t> & header, hls::stream<bool> & accept)
+{
+    #pragma HLS ARRAY_PARTITION variable=event complete
+
+    // Read and decode header
+    word_t hwHeader = input.read();
+    npuppi_t npuppi = hwHeader(7,0);
+    bool valid = ( hwHeader(63,62) == HEADER_VALID );
+    bool error = hwHeader[61];
+
+    // Clear the whole event
+    LOOP_UNPACKER_CLEAR: for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+    {
+        #pragma HLS UNROLL
+        event[i].clear();
+    }
+
+    // Unpack candidates (words above NPUPPI_MAX are read and dropped)
+    LOOP_UNPACKER_READ: for (unsigned int i = 0; i < npuppi; i++)
+    {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=0 max=255
+        word_t data = input.read();
+        if (i < NPUPPI_MAX) event[i].unpack(data);
+    }
+
+    // Per-event preselection: good header and at least one triplet
+    header.write(hwHeader);
+    accept.write(valid && !error && npuppi >= NPUPPI_MIN && npuppi <= NPUPPI_MAX);
+}
+
+// ------------------------------------------------------------------
+// Writer: forward header and highest BDT score of the accepted events only
+void writer (hls::stream<word_t> & header, hls::stream<bool> & accept, const w3p_bdt::score_t & max_score,
+             hls::stream<word_t> & out_header, hls::stream<w3p_bdt::score_t> & out_score)
+{
+    word_t hwHeader = header.read();
+    bool good = accept.read();
+    if (good)
+    {
+        out_header.write(hwHeader);
+        out_score.write(max_score);
+    }
+}
+
+// ------------------------------------------------------------------
+// Analysis main: raw scouting stream -> unpacking -> EventProcessor7f -> scores
+// Rejected events still go through EventProcessor7f (on empty candidates) so that the
+// dataflow pipeline keeps one event per interval, and are dropped by the writer.
+void analysis_main (hls::stream<word_t> & input, hls::stream<word_t> & out_header, hls::stream<w3p_bdt::score_t> & out_score)
+{
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=out_header
+    #pragma HLS INTERFACE axis port=out_score
+    #pragma HLS DATAFLOW
+
+    Puppi event[NPUPPI_MAX];
+    #pragma HLS ARRAY_PARTITION variable=event complete
+
+    hls::stream<word_t> header;
+    hls::stream<bool> accept;
+    #pragma HLS STREAM variable=header depth=4
+    #pragma HLS STREAM variable=accept depth=4
+
+    w3p_bdt::score_t max_score;
+
+    unpacker(input, event, header, accept);
+    EventProcessor7f(event, max_score);
+    writer(header, accept, max_score, out_header, out_score);
+}
+
+// ------------------------------------------------------------------
+// Streaming unpacker: same as unpacker, but each candidate is forwarded as soon as it is read
+// (count first, then the min(npuppi, NPUPPI_MAX) candidates), no zero-padding
+void unpacker_stream (hls::stream<word_t> & input, hls::stream<npuppi_t> & count, hls::stream<Puppi> & candidates,
+                      hls::stream<word_t> & header, hls::stream<bool> & accept)
+{
+    // Read and decode header
+    word_t hwHeader = input.read();
+    npuppi_t npuppi = hwHeader(7,0);
+    bool valid = ( hwHeader(63,62) == HEADER_VALID );
+    bool error = hwHeader[61];
+    count.write(npuppi > NPUPPI_MAX ? npuppi_t(NPUPPI_MAX) : npuppi);
+
+    // Unpack and forward candidates (words above NPUPPI_MAX are read and dropped)
+    LOOP_UNPACKER_STREAM: for (unsigned int i = 0; i < npuppi; i++)
+    {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=0 max=255
+        word_t data = input.read();
+        Puppi p;
+        p.unpack(data);
+        if (i < NPUPPI_MAX) candidates.write(p);
+    }
+
+    // Per-event preselection: good header and at least one triplet
+    header.write(hwHeader);
+    accept.write(valid && !error && npuppi >= NPUPPI_MIN && npuppi <= NPUPPI_MAX);
+}
+
+// ------------------------------------------------------------------
+// Streaming selector: mask each candidate and push it into a chain of NPUPPI_SEL cells
+// (insertion_push<> in pipeline.h) as it arrives, one per clock; the selected candidates
+// are ready NPUPPI_SEL-1 clocks after the last one. Keys are built from the position in
+// the stream, so the output is the same as masker + slimmer + sorter7f + selector7f on
+// the zero-padded event, without ever holding the NPUPPI_MAX candidates.
+void stream_selector7f (hls::stream<npuppi_t> & count, hls::stream<Puppi> & candidates, Puppi selected[NPUPPI_SEL])
+{
+    #pragma HLS ARRAY_PARTITION variable=selected complete
+
+    KeyedPuppi empty;
+    empty.key = 0;
+    empty.p.clear();
+
+    KeyedPuppi best[NPUPPI_SEL], carry[NPUPPI_SEL];
+    #pragma HLS ARRAY_PARTITION variable=best complete
+    #pragma HLS ARRAY_PARTITION variable=carry complete
+    insertion_clear<NPUPPI_SEL>(best, carry, empty);
+
+    // npuppi candidates, then NPUPPI_SEL-1 empty ones to flush the chain
+    // (keys of real candidates are never 0: the inverted index is at least 255 - NPUPPI_MAX)
+    npuppi_t npuppi = count.read();
+    LOOP_STREAM_SELECTOR: for (unsigned int i = 0; i < npuppi + NPUPPI_SEL - 1; i++)
+    {
+        #pragma HLS PIPELINE II=1
+        #pragma HLS LOOP_TRIPCOUNT min=NPUPPI_SEL-1 max=NPUPPI_MAX+NPUPPI_SEL-1
+        KeyedPuppi in = empty;
+        if (i < npuppi)
+        {
+            Puppi p = candidates.read();
+            if (!is_masked(p)) in.p = p;
+            in.key = make_sort_key(in.p, i);
+        }
+        insertion_push<NPUPPI_SEL>(best, carry, in);
+    }
+
+    LOOP_STREAM_SELECTED: for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+    {
+        #pragma HLS UNROLL
+        selected[i] = best[i].p;
+    }
+}
+
+// ------------------------------------------------------------------
+// Streaming analysis main: same output as analysis_main, with the candidates sorted while
+// they arrive (stream_selector7f) in place of the unpacked event going through EventProcessor7f
+void analysis_main_stream (hls::stream<word_t> & input, hls::stream<word_t> & out_header, hls::stream<w3p_bdt::score_t> & out_score)
+{
+    #pragma HLS INTERFACE axis port=input
+    #pragma HLS INTERFACE axis port=out_header
+    #pragma HLS INTERFACE axis port=out_score
+    #pragma HLS DATAFLOW
+
+    hls::stream<npuppi_t> count;
+    hls::stream<Puppi> candidates;
+    hls::stream<word_t> header;
+    hls::stream<bool> accept;
+    #pragma HLS STREAM variable=count depth=4
+    #pragma HLS STREAM variable=candidates depth=8
+    #pragma HLS STREAM variable=header depth=4
+    #pragma HLS STREAM variable=accept depth=4
+
+    Puppi selected[NPUPPI_SEL];
+    #pragma HLS ARRAY_PARTITION variable=selected complete
+
+    w3p_bdt::score_t max_score;
+
+    unpacker_stream(input, count, candidates, header, accept);
+    stream_selector7f(count, candidates, selected);
+    get_max_score(selected, max_score);
+    writer(header, accept, max_score, out_header, out_score);
+}
@@ -0,0 +1,34 @@
+#ifndef ANALYSIS_MAIN_H
+#define ANALYSIS_MAIN_H
+
+#include "event_processor.h"
+#include "hls_stream.h"
+
+// Scouting event header
+// bits     size    meaning
+// 63-62    2       10 = valid event header
+// 61       1       error bit
+// 60-56    5       (local) run number
+// 55-24    32      orbit number
+// 23-12    12      bunch crossing number (0-3563)
+// 11-08    4       must be set to 0
+// 07-00    8       number of Puppi candidates
+#define HEADER_VALID 2                    // Value of bits 63-62 for a valid event header
+#define NPUPPI_MIN 3                      // Min number of puppi candidates to process the event (one triplet)
+
+typedef ap_uint<64> word_t;               // Raw scouting word (header or packed Puppi)
+typedef ap_uint<8> npuppi_t;              // Number of candidates as stored in the header
+
+// --------------------
+// ----- FIRMWARE -----
+// --------------------
+void unpacker     (hls::stream<word_t> & input, Puppi event[NPUPPI_MAX], hls::stream<word_t> & header, hls::stream<bool> & accept);
+void writer       (hls::stream<word_t> & header, hls::stream<bool> & accept, const w3p_bdt::score_t & max_score,
+                   hls::stream<word_t> & out_header, hls::stream<w3p_bdt::score_t> & out_score);
+void analysis_main(hls::stream<word_t> & input, hls::stream<word_t> & out_header, hls::stream<w3p_bdt::score_t> & out_score);
+void unpacker_stream     (hls::stream<word_t> & input, hls::stream<npuppi_t> & count, hls::stream<Puppi> & candidates,
+                          hls::stream<word_t> & header, hls::stream<bool> & accept);
+void stream_selector7f   (hls::stream<npuppi_t> & count, hls::stream<Puppi> & candidates, Puppi selected[NPUPPI_SEL]);
+void analysis_main_stream(hls::stream<word_t> & input, hls::stream<word_t> & out_header, hls::stream<w3p_bdt::score_t> & out_score);
+
+#endif
@@ -17,7 +17,8 @@
  */
 
 /*    T -> Type template specialization will be constructed against
- *    USE_HYBRID -> use low input template specialization optimized for depth. Impl. n=2,3,4,5,6,7,12,13 (TODO known<=16)
+ *    USE_HYBRID -> use low input networks optimized for depth. Impl. n=2..16 (best known depth) and 26 (16+10 merged)
+ *    network -> family of the sorting network: Bitonic (default), OddEvenMerge or Pairwise
  */   
 
 
@@ -54,6 +55,370 @@ namespace hybridBitonicSort {
         else { if (a[i]<a[j]) myswap(a[i],a[j]);} // (2)
     } 
 
+    /*********************************************
+    *          Sorting network families          *
+    *********************************************/
+
+    /* Policies for the last template parameter of bitonicSorter:
+       Bitonic      -> recursive bitonic sorter below (+ hybrid leaves)
+       OddEvenMerge -> Batcher odd-even merge sort, as Knuth's merge exchange (Algorithm 5.2.2M), any N
+       Pairwise     -> Parberry pairwise sorting network, any N
+       For N=2^k OddEvenMerge and Pairwise have the depth of Bitonic with fewer comparators.
+       generate(n, v, hybrid) calls v.add(i,j) for each comparator (min to i in ascending
+       order) in an order respecting the dependencies; sorterComparators/sorterDepth below
+       report the size of each network at compile time. */
+
+    template<int M, typename V>
+    static constexpr void addComparators(const int (&c)[M][2], int low, V & v) {
+        for (int k = 0; k < M; k++) v.add(low + c[k][0], low + c[k][1]);
+    }
+
+    // Hybrid leaves: low input networks optimized for depth, one level per line
+    static constexpr int HYBRID_3[][2] = {
+        {0,1}, {1,2},
+        {0,1} };
+    static constexpr int HYBRID_4[][2] = {
+        {0,1}, {2,3},
+        {0,2}, {1,3},
+        {1,2} };
+    static constexpr int HYBRID_5[][2] = {
+        {0,1}, {2,3},
+        {1,3}, {2,4},
+        {0,2}, {1,4},
+        {1,2}, {3,4},
+        {2,3} };
+    static constexpr int HYBRID_6[][2] = {
+        {0,3}, {1,2},
+        {0,1}, {2,3}, {4,5},
+        {0,3}, {1,4}, {2,5},
+        {0,1}, {2,4}, {3,5},
+        {1,2}, {3,4} };
+    static constexpr int HYBRID_7[][2] = { // HYBRID_8 without wire 7
+        {0,1}, {2,3}, {4,5},
+        {0,2}, {1,3}, {4,6},
+        {1,2}, {5,6},
+        {0,4}, {1,5}, {2,6},
+        {2,4}, {3,5},
+        {1,2}, {3,4}, {5,6} };
+    static constexpr int HYBRID_8[][2] = {
+        {0,1}, {2,3}, {4,5}, {6,7},
+        {0,2}, {1,3}, {4,6}, {5,7},
+        {1,2}, {5,6},
+        {0,4}, {1,5}, {2,6}, {3,7},
+        {2,4}, {3,5},
+        {1,2}, {3,4}, {5,6} };
+    static constexpr int HYBRID_9[][2] = {
+        {0,3}, {1,7}, {2,5}, {4,8},
+        {0,7}, {2,4}, {3,8}, {5,6},
+        {0,2}, {1,3}, {4,5}, {7,8},
+        {1,4}, {3,6}, {5,7},
+        {0,1}, {2,4}, {3,5}, {6,8},
+        {2,3}, {4,5}, {6,7},
+        {1,2}, {3,4}, {5,6} };
+    static constexpr int HYBRID_10[][2] = {
+        {0,1}, {2,5}, {3,6}, {4,7}, {8,9},
+        {0,6}, {1,8}, {2,4}, {3,9}, {5,7},
+        {0,2}, {1,3}, {4,5}, {6,8}, {7,9},
+        {0,1}, {2,7}, {3,5}, {4,6}, {8,9},
+        {1,2}, {3,4}, {5,6}, {7,8},
+        {1,3}, {2,4}, {5,7}, {6,8},
+        {2,3}, {4,5}, {6,7} };
+    static constexpr int HYBRID_11[][2] = {
+        {0,9}, {1,6}, {2,4}, {3,7}, {5,8},
+        {0,1}, {3,5}, {4,10}, {6,9}, {7,8},
+        {1,3}, {2,5}, {4,7}, {8,10},
+        {0,4}, {1,2}, {3,7}, {5,9}, {6,8},
+        {0,1}, {2,6}, {4,5}, {7,8}, {9,10},
+        {2,4}, {3,6}, {5,7}, {8,9},
+        {1,2}, {3,4}, {5,6}, {7,8},
+        {2,3}, {4,5}, {6,7} };
+    static constexpr int HYBRID_12[][2] = {
+        {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11},
+        {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11},
+        {0,4}, {1,5}, {2,6}, {7,11}, {9,10},
+        {1,2}, {6,10}, {5,9}, {4,8}, {3,7},
+        {2,6}, {1,5}, {0,4}, {9,10}, {7,11}, {3,8},
+        {1,4}, {7,10}, {2,3}, {5,6}, {8,9},
+        {2,4}, {3,5}, {6,8}, {7,9},
+        {3,4}, {5,6}, {7,8} };
+    static constexpr int HYBRID_13[][2] = {
+        {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11},
+        {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11},
+        {0,4}, {1,5}, {2,6}, {3,7}, {8,12},
+        {0,8}, {1,9}, {2,10}, {3,11}, {4,12},
+        {1,2}, {3,12}, {7,11}, {4,8}, {5,10}, {6,9},
+        {1,4}, {2,8}, {6,12}, {3,10}, {5,9},
+        {2,4}, {3,5}, {6,8}, {7,9}, {10,12},
+        {3,6}, {5,8}, {7,10}, {9,12},
+        {3,4}, {5,6}, {7,8}, {9,10}, {11,12} };
+    static constexpr int HYBRID_14[][2] = {
+        {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13},
+        {0,2}, {1,3}, {4,8}, {5,9}, {10,12}, {11,13},
+        {0,10}, {1,6}, {2,11}, {3,13}, {5,8}, {7,12},
+        {1,4}, {2,8}, {3,6}, {5,11}, {7,10}, {9,12},
+        {0,1}, {3,9}, {4,10}, {5,7}, {6,8}, {12,13},
+        {1,5}, {2,4}, {3,7}, {6,10}, {8,12}, {9,11},
+        {1,2}, {3,5}, {4,6}, {7,9}, {8,10}, {11,12},
+        {2,3}, {4,5}, {6,7}, {8,9}, {10,11},
+        {3,4}, {5,6}, {7,8}, {9,10} };
+    static constexpr int HYBRID_15[][2] = { // HYBRID_16 without wire 15
+        {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13},
+        {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14},
+        {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14},
+        {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14},
+        {1,2}, {3,9}, {4,8}, {5,12}, {6,10}, {7,11}, {13,14},
+        {1,4}, {2,8}, {3,10}, {5,9}, {6,12}, {7,13}, {11,14},
+        {2,4}, {3,8}, {5,6}, {7,12}, {9,10}, {11,13},
+        {3,5}, {6,8}, {7,9}, {10,12},
+        {3,4}, {5,6}, {7,8}, {9,10}, {11,12} };
+    static constexpr int HYBRID_16[][2] = {
+        {0,1}, {2,3}, {4,5}, {6,7}, {8,9}, {10,11}, {12,13}, {14,15},
+        {0,2}, {1,3}, {4,6}, {5,7}, {8,10}, {9,11}, {12,14}, {13,15},
+        {0,4}, {1,5}, {2,6}, {3,7}, {8,12}, {9,13}, {10,14}, {11,15},
+        {0,8}, {1,9}, {2,10}, {3,11}, {4,12}, {5,13}, {6,14}, {7,15},
+        {1,2}, {3,9}, {4,8}, {5,12}, {6,10}, {7,11}, {13,14},
+        {1,4}, {2,8}, {3,10}, {5,9}, {6,12}, {7,13}, {11,14},
+        {2,4}, {3,8}, {5,6}, {7,12}, {9,10}, {11,13},
+        {3,5}, {6,8}, {7,9}, {10,12},
+        {3,4}, {5,6}, {7,8}, {9,10}, {11,12} };
+
+    // Batcher odd-even merge of two sorted runs of na and nb elements starting at low.
+    // Runs on 2m wires (m: power of 2 >= na, nb), the first run ending at wire m and the
+    // second starting there; the wires outside the runs hold -inf below and +inf above,
+    // never move, so their comparators are dropped.
+    template<typename V>
+    static constexpr void paddedMerge(int na, int nb, V & v, int low, int m, int lo, int n, int r) {
+        int step = 2*r;
+        if (step < n) {
+            paddedMerge(na, nb, v, low, m, lo, n, step);
+            paddedMerge(na, nb, v, low, m, lo+r, n, step);
+            for (int i = lo+r; i < lo+n-r; i += step)
+                if (i >= m-na && i+r < m+nb) v.add(low + i-(m-na), low + i+r-(m-na));
+        } else if (lo >= m-na && lo+r < m+nb) {
+            v.add(low + lo-(m-na), low + lo+r-(m-na));
+        }
+    }
+
+    template<typename V>
+    static constexpr void paddedMerge(int na, int nb, V & v, int low) {
+        int m = 1;
+        while (m < na || m < nb) m *= 2;
+        paddedMerge(na, nb, v, low, m, 0, 2*m, 1);
+    }
+
+    struct HybridLeaf {
+        static constexpr bool has(int n) {
+            return (n >= 3 && n <= 16) || n == 26;
+        }
+        template<typename V>
+        static constexpr void generate(int n, V & v, bool /*hybrid*/ = true, int low = 0) {
+            if      (n == 3)  addComparators(HYBRID_3,  low, v);
+            else if (n == 4)  addComparators(HYBRID_4,  low, v);
+            else if (n == 5)  addComparators(HYBRID_5,  low, v);
+            else if (n == 6)  addComparators(HYBRID_6,  low, v);
+            else if (n == 7)  addComparators(HYBRID_7,  low, v);
+            else if (n == 8)  addComparators(HYBRID_8,  low, v);
+            else if (n == 9)  addComparators(HYBRID_9,  low, v);
+            else if (n == 10) addComparators(HYBRID_10, low, v);
+            else if (n == 11) addComparators(HYBRID_11, low, v);
+            else if (n == 12) addComparators(HYBRID_12, low, v);
+            else if (n == 13) addComparators(HYBRID_13, low, v);
+            else if (n == 14) addComparators(HYBRID_14, low, v);
+            else if (n == 15) addComparators(HYBRID_15, low, v);
+            else if (n == 16) addComparators(HYBRID_16, low, v);
+            else if (n == 26) {
+                // 16 + 10 and a merge: depth 9 + 5, 144 comparators (vs 151 for 13 + 13 and a bitonic merge)
+                addComparators(HYBRID_16, low, v);
+                addComparators(HYBRID_10, low+16, v);
+                paddedMerge(16, 10, v, low);
+            }
+        }
+    };
+
+    struct Bitonic {
+        // same recursion as bitonicMerger/bitonicSorter (directions do not change the comparators)
+        template<typename V>
+        static constexpr void merge(int n, V & v, int low) {
+            if (n < 2) return;
+            int k = PowerOf2LessThan(n);
+            for (int i = low; i < low+n-k; i++) v.add(i, i+k);
+            merge(k, v, low);
+            merge(n-k, v, low+k);
+        }
+        template<typename V>
+        static constexpr void generate(int n, V & v, bool hybrid = false, int low = 0) {
+            if (hybrid && HybridLeaf::has(n)) {
+                HybridLeaf::generate(n, v, hybrid, low);
+            } else if (n > 1) {
+                generate(n/2, v, hybrid, low);
+                generate(n-n/2, v, hybrid, low+n/2);
+                merge(n, v, low);
+            }
+        }
+    };
+
+    struct OddEvenMerge {
+        template<typename V>
+        static constexpr void generate(int n, V & v, bool /*hybrid*/ = false) {
+            int t = 0;
+            while ((1 << t) < n) t++;
+            for (int p = (t > 0 ? 1 << (t-1) : 0); p > 0; p >>= 1) {
+                int q = 1 << (t-1), r = 0, d = p;
+                while (d > 0) {
+                    for (int i = 0; i < n-d; i++)
+                        if ((i & p) == r) v.add(i, i+d);
+                    d = q-p;
+                    q >>= 1;
+                    r = p;
+                }
+            }
+        }
+    };
+
+    struct Pairwise {
+        template<typename V>
+        static constexpr void generate(int n, V & v, bool /*hybrid*/ = false) {
+            // sort pairs, pairs of pairs, ... (lower elements of the pairs at even positions)
+            int a = 1;
+            for (; a < n; a *= 2) {
+                for (int b = a, c = 0; b < n; ) {
+                    v.add(b-a, b);
+                    b++;
+                    if (++c == a) { c = 0; b += a; }
+                }
+            }
+            // then merge them back
+            for (int e = 1, s = a/4; s > 0; s /= 2, e = 2*e+1) {
+                for (int d = e; d > 0; d /= 2) {
+                    for (int b = (d+1)*s, c = 0; b < n; ) {
+                        v.add(b-d*s, b);
+                        b++;
+                        if (++c == s) { c = 0; b += s; }
+                    }
+                }
+            }
+        }
+    };
+
+    static constexpr int MAX_NETWORK_SIZE = 256;
+
+    // Comparator count and depth (longest chain of comparators) of a generated network
+    struct networkStats {
+        int comparators;
+        int depth;
+        int level[MAX_NETWORK_SIZE];
+        constexpr void add(int i, int j) {
+            int l = (level[i] > level[j] ? level[i] : level[j]) + 1;
+            level[i] = l;
+            level[j] = l;
+            if (l > depth) depth = l;
+            comparators++;
+        }
+    };
+
+    template<typename network, bool hybrid>
+    constexpr networkStats generatedStats(int n) {
+        networkStats s{};
+        network::generate(n, s, hybrid);
+        return s;
+    }
+
+    // Comparators and depth of bitonicSorter<T, N, dir, hybrid, network>
+    template<typename network, bool hybrid=false>
+    constexpr int sorterComparators(int n) { return generatedStats<network, hybrid>(n).comparators; }
+
+    template<typename network, bool hybrid=false>
+    constexpr int sorterDepth(int n) { return generatedStats<network, hybrid>(n).depth; }
+
+    // 0-1 principle: a comparator network sorts every input if it sorts the 2^n inputs of 0s and 1s.
+    // Bit x of each wire is the input number 64*block+x, so that a comparator is one AND and one OR.
+    static constexpr int MAX_ZERO_ONE_SIZE = 32;
+
+    struct zeroOneInputs {
+        unsigned long long w[MAX_ZERO_ONE_SIZE];
+        constexpr void add(int i, int j) {
+            unsigned long long a = w[i], b = w[j];
+            w[i] = a & b;
+            w[j] = a | b;
+        }
+    };
+
+    // Checks the generated network (min to i for each comparator, not the bitonic directions) on the
+    // 0-1 inputs numbered [64*first, 64*last)
+    template<typename network, bool hybrid>
+    constexpr bool sortsZeroOne(int n, unsigned long long first, unsigned long long last) {
+        constexpr unsigned long long lanes[6] = {
+            0xAAAAAAAAAAAAAAAAULL, 0xCCCCCCCCCCCCCCCCULL, 0xF0F0F0F0F0F0F0F0ULL,
+            0xFF00FF00FF00FF00ULL, 0xFFFF0000FFFF0000ULL, 0xFFFFFFFF00000000ULL };
+        for (unsigned long long block = first; block < last; block++) {
+            zeroOneInputs s{};
+            for (int k = 0; k < n; k++) s.w[k] = k < 6 ? lanes[k] : ((block >> (k-6)) & 1) ? ~0ULL : 0ULL;
+            network::generate(n, s, hybrid);
+            for (int k = 0; k+1 < n; k++)
+                if (s.w[k] & ~s.w[k+1]) return false;
+        }
+        return true;
+    }
+
+    template<typename network, bool hybrid=false>
+    constexpr bool sortsZeroOne(int n) {
+        return n <= MAX_ZERO_ONE_SIZE && sortsZeroOne<network, hybrid>(n, 0, n > 6 ? 1ULL << (n-6) : 1);
+    }
+
+    // Hybrid leaves up to 16 inputs checked at compile time (26, 2^20 blocks, in tools/sorting_networks.cc)
+    template<int N>
+    struct hybridLeafCheck : hybridLeafCheck<N-1> {
+        static_assert(!HybridLeaf::has(N) || sortsZeroOne<HybridLeaf, true>(N), "hybrid leaf does not sort");
+    };
+
+    template<>
+    struct hybridLeafCheck<2> {};
+
+    static_assert(sizeof(hybridLeafCheck<16>) > 0, "");
+
+    // Comparators of a generated network, as a table
+    template<int SIZE>
+    struct comparatorList {
+        int lo[SIZE];
+        int hi[SIZE];
+        int size;
+        constexpr void add(int i, int j) {
+            lo[size] = i;
+            hi[size] = j;
+            size++;
+        }
+    };
+
+    template<typename network, int N, bool hybrid>
+    struct comparatorTable {
+        static_assert(N <= MAX_NETWORK_SIZE, "network too large");
+        static constexpr int size = sorterComparators<network, hybrid>(N);
+        typedef comparatorList<size ? size : 1> list_t;
+        static constexpr list_t make() {
+            list_t l{};
+            network::generate(N, l, hybrid);
+            return l;
+        }
+        static constexpr list_t list = make();
+    };
+
+    template<typename network, int N, bool hybrid>
+    constexpr typename comparatorTable<network, N, hybrid>::list_t comparatorTable<network, N, hybrid>::list;
+
+    // Sort with the comparators of a generated network
+    template<typename T, int N, int dir, typename network, bool hybrid=false>
+    struct networkSorter {
+        inline static void run(T a[], int low) {
+            #pragma HLS inline
+            #pragma HLS array_partition variable=a complete
+            typedef comparatorTable<network, N, hybrid> table;
+            for (int c = 0; c < table::size; c++) {
+                #pragma HLS unroll
+                compAndSwap<T,dir>(a, low + table::list.lo[c], low + table::list.hi[c]);
+            }
+        }
+    };
+
     /*********************************************
     *             bitonicMerger                  *
     *********************************************/
@@ -98,7 +463,7 @@ namespace hybridBitonicSort {
     /* This function first produces a bitonic sequence by recursively 
        sorting its two halves in opposite sorting orders, and then 
        calls bitonicMerge to make them in the same order */
-    template <typename T, int N, int dir, bool hybrid=false>
+    template <typename T, int N, int dir, bool hybrid=false, typename network=Bitonic>
     struct bitonicSorter {
         inline static void run(T a[],int low) { 
             #pragma HLS inline
@@ -107,7 +472,12 @@ namespace hybridBitonicSort {
             static constexpr int upperSize= N-N/2;
             static constexpr int notDir = not dir;
 
-            if (N>1) 
+            if (hybrid && HybridLeaf::has(N))
+            {
+                // low input network optimized for depth
+                networkSorter<T,N,dir,HybridLeaf,hybrid>::run(a, low);
+            }
+            else if (N>1) 
             { 
                 // sort in ascending order since dir here is 1 
                 //bitonicSort(a, low, k, 1);  // dir, ?
@@ -142,197 +512,12 @@ namespace hybridBitonicSort {
         }
     };
 
-    /******************* N=3 ********************/
-    template<typename T, int dir>
-    struct bitonicSorter<T, 3, dir, true> {
-        inline static void run(T a[], int low){
-            #pragma HLS inline
-            #pragma HLS array_partition variable=a complete
-            compAndSwap<T,dir>(a, low+0, low+1); 
-            compAndSwap<T,dir>(a, low+1, low+2); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+1); 
-        }
-    };
-
-    /******************* N=4 ********************/
-    template<typename T, int dir>
-    struct bitonicSorter<T, 4, dir, true> {
-        inline static void run(T a[], int low){
-            #pragma HLS inline
-            #pragma HLS array_partition variable=a complete
-            compAndSwap<T,dir>(a, low+0, low+1); 
-            compAndSwap<T,dir>(a, low+2, low+3); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+2); 
-            compAndSwap<T,dir>(a, low+1, low+3); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+2); 
-        }
-    };
-
-    /******************* N=5 ********************/
-    template<typename T, int dir>
-    struct bitonicSorter<T, 5, dir, true> {
-        inline static void run(T a[], int low){
-            #pragma HLS inline
-            #pragma HLS array_partition variable=a complete
-            compAndSwap<T,dir>(a, low+0, low+1); 
-            compAndSwap<T,dir>(a, low+2, low+3); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+3); 
-            compAndSwap<T,dir>(a, low+2, low+4); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+2); 
-            compAndSwap<T,dir>(a, low+1, low+4); 
-            //--
-            compAndSwap<T,dir>(a, low+1, low+2); 
-            compAndSwap<T,dir>(a, low+3, low+4); 
-            //--
-            compAndSwap<T,dir>(a, low+2, low+3); 
-        }
-    };
-
-    /******************* N=6 ********************/
-    template<typename T, int dir>
-    struct bitonicSorter<T, 6, dir, true> {
-        inline static void run(T a[], int low){
-            #pragma HLS inline
-            #pragma HLS array_partition variable=a complete
-            //---
-            compAndSwap<T,dir>(a, low+0, low+3); 
-            compAndSwap<T,dir>(a, low+1, low+2); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+1); 
-            compAndSwap<T,dir>(a, low+2, low+3); 
-            compAndSwap<T,dir>(a, low+4, low+5); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+3); 
-            compAndSwap<T,dir>(a, low+1, low+4); 
-            compAndSwap<T,dir>(a, low+2, low+5); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+1); 
-            compAndSwap<T,dir>(a, low+2, low+4); 
-            compAndSwap<T,dir>(a, low+3, low+5); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+2); 
-            compAndSwap<T,dir>(a, low+3, low+4); 
-        }
-    };
+    /************* other families ***************/
+    template<typename T, int N, int dir, bool hybrid>
+    struct bitonicSorter<T, N, dir, hybrid, OddEvenMerge> : networkSorter<T, N, dir, OddEvenMerge> {};
 
-    /******************* N=12 ********************/
-    template<typename T, int dir>
-    struct bitonicSorter<T, 12, dir, true> {
-        inline static void run(T a[], int low){
-            #pragma HLS inline
-            #pragma HLS array_partition variable=a complete
-            for(int i=0;i<12;i+=2){
-                #pragma HLS unroll
-                compAndSwap<T,dir>(a, low+i, low+i+1); 
-            }
-            //---
-            for(int i=0;i<12;i+=4){
-                #pragma HLS unroll
-                compAndSwap<T,dir>(a, low+i+0, low+i+2); 
-                compAndSwap<T,dir>(a, low+i+1, low+i+3); 
-            }
-            //---
-            compAndSwap<T,dir>(a, low+0, low+4); 
-            compAndSwap<T,dir>(a, low+1, low+5); 
-            compAndSwap<T,dir>(a, low+2, low+6); 
-            compAndSwap<T,dir>(a, low+7, low+11); 
-            compAndSwap<T,dir>(a, low+9, low+10); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+2); 
-            compAndSwap<T,dir>(a, low+6, low+10); 
-            compAndSwap<T,dir>(a, low+5, low+9); 
-            compAndSwap<T,dir>(a, low+4, low+8); 
-            compAndSwap<T,dir>(a, low+3, low+7); 
-            //---
-            compAndSwap<T,dir>(a, low+2, low+6); 
-            compAndSwap<T,dir>(a, low+1, low+5); 
-            compAndSwap<T,dir>(a, low+0, low+4); 
-            compAndSwap<T,dir>(a, low+9, low+10); 
-            compAndSwap<T,dir>(a, low+7, low+11); 
-            compAndSwap<T,dir>(a, low+3, low+8); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+4); 
-            compAndSwap<T,dir>(a, low+7, low+10); 
-            compAndSwap<T,dir>(a, low+2, low+3); 
-            compAndSwap<T,dir>(a, low+5, low+6); 
-            compAndSwap<T,dir>(a, low+8, low+9); 
-            //---
-            compAndSwap<T,dir>(a, low+2, low+4); 
-            compAndSwap<T,dir>(a, low+3, low+5); 
-            compAndSwap<T,dir>(a, low+6, low+8); 
-            compAndSwap<T,dir>(a, low+7, low+9); 
-            //---
-            compAndSwap<T,dir>(a, low+3, low+4); 
-            compAndSwap<T,dir>(a, low+5, low+6); 
-            compAndSwap<T,dir>(a, low+7, low+8); 
-        }
-    };
-
-    /******************* N=13 ********************/
-    template<typename T, int dir>
-    struct bitonicSorter<T, 13, dir, true> {
-        inline static void run(T a[], int low){
-            #pragma HLS inline
-            #pragma HLS array_partition variable=a complete
-            for(int i=0;i+1<13;i+=2){
-                #pragma HLS unroll
-                compAndSwap<T,dir>(a, low+i, low+i+1); 
-            }
-            //---
-            for(int i=0;i+3<13;i+=4){
-                #pragma HLS unroll
-                compAndSwap<T,dir>(a, low+i+0, low+i+2); 
-                compAndSwap<T,dir>(a, low+i+1, low+i+3); 
-            }
-            //---
-            compAndSwap<T,dir>(a, low+0, low+4); 
-            compAndSwap<T,dir>(a, low+1, low+5); 
-            compAndSwap<T,dir>(a, low+2, low+6); 
-            compAndSwap<T,dir>(a, low+3, low+7); 
-            compAndSwap<T,dir>(a, low+8, low+12); 
-            //---
-            compAndSwap<T,dir>(a, low+0, low+8); 
-            compAndSwap<T,dir>(a, low+1, low+9); 
-            compAndSwap<T,dir>(a, low+2, low+10); 
-            compAndSwap<T,dir>(a, low+3, low+11); 
-            compAndSwap<T,dir>(a, low+4, low+12); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+2); 
-            compAndSwap<T,dir>(a, low+3, low+12); 
-            compAndSwap<T,dir>(a, low+7, low+11); 
-            compAndSwap<T,dir>(a, low+4, low+8); 
-            compAndSwap<T,dir>(a, low+5, low+10); 
-            compAndSwap<T,dir>(a, low+6, low+9); 
-            //---
-            compAndSwap<T,dir>(a, low+1, low+4); 
-            compAndSwap<T,dir>(a, low+2, low+8); 
-            compAndSwap<T,dir>(a, low+6, low+12); 
-            compAndSwap<T,dir>(a, low+3, low+10); 
-            compAndSwap<T,dir>(a, low+5, low+9); 
-            //---
-            compAndSwap<T,dir>(a, low+2, low+4); 
-            compAndSwap<T,dir>(a, low+3, low+5); 
-            compAndSwap<T,dir>(a, low+6, low+8); 
-            compAndSwap<T,dir>(a, low+7, low+9); 
-            compAndSwap<T,dir>(a, low+10, low+12); 
-            //---
-            compAndSwap<T,dir>(a, low+3, low+6); 
-            compAndSwap<T,dir>(a, low+5, low+8); 
-            compAndSwap<T,dir>(a, low+7, low+10); 
-            compAndSwap<T,dir>(a, low+9, low+12); 
-            //---
-            compAndSwap<T,dir>(a, low+3, low+4); 
-            compAndSwap<T,dir>(a, low+5, low+6); 
-            compAndSwap<T,dir>(a, low+7, low+8); 
-            compAndSwap<T,dir>(a, low+9, low+10); 
-            compAndSwap<T,dir>(a, low+11, low+12); 
-        }
-    };
+    template<typename T, int N, int dir, bool hybrid>
+    struct bitonicSorter<T, N, dir, hybrid, Pairwise> : networkSorter<T, N, dir, Pairwise> {};
 
     // Just and interface
     template<int NIN,int NOUT,bool hybrid=false,int dir=0, typename T>
@@ -0,0 +1,211 @@
+#ifndef COSCOSH_LUT_H
+#define COSCOSH_LUT_H
+
+#include "data.h"
+
+// ------------------------------------------------------------------
+// cos and cosh ROMs of get_cos_phi/get_cosh_eta/get_coshw_eta, indexed by |dphi| and |deta|
+// in units of Puppi::ETAPHI_LSB, values times COSCOSH_LSB (_lut_cos_init/_lut_cosh_init/_lut_coshw_init)
+// Generated by tools/make_coscosh_lut.cc: do not edit
+static const cos_t   LUT_COS  [COSCOSH_LUT_SIZE] = {
+    256, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 254, 254, 254, 254, 254, 254, 254, 254, 253, 253, 253,
+    253, 253, 253, 253, 252, 252, 252, 252, 252, 251, 251, 251, 251, 251, 250, 250,
+    250, 250, 249, 249, 249, 249, 248, 248, 248, 248, 247, 247, 247, 246, 246, 246,
+    246, 245, 245, 245, 244, 244, 244, 243, 243, 243, 242, 242, 242, 241, 241, 240,
+    240, 240, 239, 239, 238, 238, 238, 237, 237, 236, 236, 236, 235, 235, 234, 234,
+    233, 233, 232, 232, 232, 231, 231, 230, 230, 229, 229, 228, 228, 227, 227, 226,
+    226, 225, 224, 224, 223, 223, 222, 222, 221, 221, 220, 220, 219, 218, 218, 217,
+    217, 216, 215, 215, 214, 214, 213, 212, 212, 211, 210, 210, 209, 209, 208, 207,
+    207, 206, 205, 205, 204, 203, 203, 202, 201, 201, 200, 199, 198, 198, 197, 196,
+    196, 195, 194, 193, 193, 192, 191, 190, 190, 189, 188, 187, 187, 186, 185, 184,
+    184, 183, 182, 181, 181, 180, 179, 178, 177, 177, 176, 175, 174, 173, 172, 172,
+    171, 170, 169, 168, 167, 167, 166, 165, 164, 163, 162, 161, 161, 160, 159, 158,
+    157, 156, 155, 154, 154, 153, 152, 151, 150, 149, 148, 147, 146, 145, 145, 144,
+    143, 142, 141, 140, 139, 138, 137, 136, 135, 134, 133, 132, 131, 130, 129, 128,
+    127, 127, 126, 125, 124, 123, 122, 121, 120, 119, 118, 117, 116, 115, 114, 113,
+    112, 111, 110, 109, 108, 107, 106, 105, 104, 103, 102, 101, 100, 98, 97, 96,
+    95, 94, 93, 92, 91, 90, 89, 88, 87, 86, 85, 84, 83, 82, 81, 80,
+    79, 78, 76, 75, 74, 73, 72, 71, 70, 69, 68, 67, 66, 65, 64, 63,
+    61, 60, 59, 58, 57, 56, 55, 54, 53, 52, 51, 49, 48, 47, 46, 45,
+    44, 43, 42, 41, 40, 38, 37, 36, 35, 34, 33, 32, 31, 30, 28, 27,
+    26, 25, 24, 23, 22, 21, 20, 18, 17, 16, 15, 14, 13, 12, 11, 10,
+    8, 7, 6, 5, 4, 3, 2, 1, 0, -1, -2, -3, -4, -5, -6, -7,
+    -8, -10, -11, -12, -13, -14, -15, -16, -17, -18, -20, -21, -22, -23, -24, -25,
+    -26, -27, -28, -30, -31, -32, -33, -34, -35, -36, -37, -38, -40, -41, -42, -43,
+    -44, -45, -46, -47, -48, -49, -51, -52, -53, -54, -55, -56, -57, -58, -59, -60,
+    -61, -63, -64, -65, -66, -67, -68, -69, -70, -71, -72, -73, -74, -75, -76, -78,
+    -79, -80, -81, -82, -83, -84, -85, -86, -87, -88, -89, -90, -91, -92, -93, -94,
+    -95, -96, -97, -98, -100, -101, -102, -103, -104, -105, -106, -107, -108, -109, -110, -111,
+    -112, -113, -114, -115, -116, -117, -118, -119, -120, -121, -122, -123, -124, -125, -126, -127,
+    -128, -128, -129, -130, -131, -132, -133, -134, -135, -136, -137, -138, -139, -140, -141, -142,
+    -143, -144, -145, -145, -146, -147, -148, -149, -150, -151, -152, -153, -154, -154, -155, -156,
+    -157, -158, -159, -160, -161, -161, -162, -163, -164, -165, -166, -167, -167, -168, -169, -170,
+    -171, -172, -172, -173, -174, -175, -176, -177, -177, -178, -179, -180, -181, -181, -182, -183,
+    -184, -184, -185, -186, -187, -187, -188, -189, -190, -190, -191, -192, -193, -193, -194, -195,
+    -196, -196, -197, -198, -198, -199, -200, -201, -201, -202, -203, -203, -204, -205, -205, -206,
+    -207, -207, -208, -209, -209, -210, -210, -211, -212, -212, -213, -214, -214, -215, -215, -216,
+    -217, -217, -218, -218, -219, -220, -220, -221, -221, -222, -222, -223, -223, -224, -224, -225,
+    -226, -226, -227, -227, -228, -228, -229, -229, -230, -230, -231, -231, -232, -232, -232, -233,
+    -233, -234, -234, -235, -235, -236, -236, -236, -237, -237, -238, -238, -238, -239, -239, -240,
+    -240, -240, -241, -241, -242, -242, -242, -243, -243, -243, -244, -244, -244, -245, -245, -245,
+    -246, -246, -246, -246, -247, -247, -247, -248, -248, -248, -248, -249, -249, -249, -249, -250,
+    -250, -250, -250, -251, -251, -251, -251, -251, -252, -252, -252, -252, -252, -253, -253, -253,
+    -253, -253, -253, -253, -254, -254, -254, -254, -254, -254, -254, -254, -255, -255, -255, -255,
+    -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255,
+    -256, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255, -255,
+    -255, -255, -255, -255, -255, -254, -254, -254, -254, -254, -254, -254, -254, -253, -253, -253,
+    -253, -253, -253, -253, -252, -252, -252, -252, -252, -251, -251, -251, -251, -251, -250, -250,
+    -250, -250, -249, -249, -249, -249, -248, -248, -248, -248, -247, -247, -247, -246, -246, -246,
+    -246, -245, -245, -245, -244, -244, -244, -243, -243, -243, -242, -242, -242, -241, -241, -240,
+    -240, -240, -239, -239, -238, -238, -238, -237, -237, -236, -236, -236, -235, -235, -234, -234,
+    -233, -233, -232, -232, -232, -231, -231, -230, -230, -229, -229, -228, -228, -227, -227, -226,
+    -226, -225, -224, -224, -223, -223, -222, -222, -221, -221, -220, -220, -219, -218, -218, -217,
+    -217, -216, -215, -215, -214, -214, -213, -212, -212, -211, -210, -210, -209, -209, -208, -207,
+    -207, -206, -205, -205, -204, -203, -203, -202, -201, -201, -200, -199, -198, -198, -197, -196,
+    -196, -195, -194, -193, -193, -192, -191, -190, -190, -189, -188, -187, -187, -186, -185, -184,
+    -184, -183, -182, -181, -181, -180, -179, -178, -177, -177, -176, -175, -174, -173, -172, -172,
+    -171, -170, -169, -168, -167, -167, -166, -165, -164, -163, -162, -161, -161, -160, -159, -158,
+    -157, -156, -155, -154, -154, -153, -152, -151, -150, -149, -148, -147, -146, -145, -144, -144,
+    -143, -142, -141, -140, -139, -138, -137, -136, -135, -134, -133, -132, -131, -130, -129, -128,
+    -127, -127, -126, -125, -124, -123, -122, -121, -120, -119, -118, -117, -116, -115, -114, -113,
+    -112, -111, -110, -109, -108, -107, -106, -105, -104, -103, -102, -101, -100, -98, -97, -96,
+    -95, -94, -93, -92, -91, -90, -89, -88, -87, -86, -85, -84, -83, -82, -81, -80,
+    -79, -78, -76, -75, -74, -73, -72, -71, -70, -69, -68, -67, -66, -65, -64, -63
+};
+
+static const cosh_t  LUT_COSH [COSCOSH_LUT_SIZE] = {
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 257, 257, 257, 257, 257, 257, 257, 257, 258, 258, 258,
+    258, 258, 258, 258, 259, 259, 259, 259, 259, 260, 260, 260, 260, 260, 261, 261,
+    261, 261, 262, 262, 262, 262, 263, 263, 263, 263, 264, 264, 264, 265, 265, 265,
+    266, 266, 266, 267, 267, 267, 268, 268, 268, 269, 269, 269, 270, 270, 270, 271,
+    271, 272, 272, 272, 273, 273, 274, 274, 275, 275, 275, 276, 276, 277, 277, 278,
+    278, 279, 279, 280, 280, 281, 281, 282, 282, 283, 283, 284, 284, 285, 286, 286,
+    287, 287, 288, 288, 289, 290, 290, 291, 291, 292, 293, 293, 294, 295, 295, 296,
+    296, 297, 298, 298, 299, 300, 301, 301, 302, 303, 303, 304, 305, 305, 306, 307,
+    308, 308, 309, 310, 311, 312, 312, 313, 314, 315, 316, 316, 317, 318, 319, 320,
+    320, 321, 322, 323, 324, 325, 326, 327, 327, 328, 329, 330, 331, 332, 333, 334,
+    335, 336, 337, 338, 339, 340, 341, 342, 343, 344, 345, 346, 347, 348, 349, 350,
+    351, 352, 353, 354, 355, 356, 357, 358, 359, 360, 362, 363, 364, 365, 366, 367,
+    368, 370, 371, 372, 373, 374, 375, 377, 378, 379, 380, 382, 383, 384, 385, 387,
+    388, 389, 390, 392, 393, 394, 396, 397, 398, 400, 401, 402, 404, 405, 406, 408,
+    409, 411, 412, 413, 415, 416, 418, 419, 421, 422, 424, 425, 426, 428, 429, 431,
+    433, 434, 436, 437, 439, 440, 442, 443, 445, 447, 448, 450, 451, 453, 455, 456,
+    458, 460, 461, 463, 465, 466, 468, 470, 472, 473, 475, 477, 479, 480, 482, 484,
+    486, 487, 489, 491, 493, 495, 497, 499, 500, 502, 504, 506, 508, 510, 512, 514,
+    516, 518, 520, 522, 524, 526, 528, 530, 532, 534, 536, 538, 540, 542, 544, 546,
+    548, 550, 553, 555, 557, 559, 561, 563, 566, 568, 570, 572, 574, 577, 579, 581,
+    584, 586, 588, 590, 593, 595, 598, 600, 602, 605, 607, 609, 612, 614, 617, 619,
+    622, 624, 627, 629, 632, 634, 637, 639, 642, 644, 647, 650, 652, 655, 657, 660,
+    663, 665, 668, 671, 674, 676, 679, 682, 685, 687, 690, 693, 696, 699, 701, 704,
+    707, 710, 713, 716, 719, 722, 725, 728, 731, 734, 737, 740, 743, 746, 749, 752,
+    755, 758, 761, 764, 768, 771, 774, 777, 780, 784, 787, 790, 793, 797, 800, 803,
+    807, 810, 813, 817, 820, 823, 827, 830, 834, 837, 841, 844, 848, 851, 855, 858,
+    862, 866, 869, 873, 876, 880, 884, 888, 891, 895, 899, 902, 906, 910, 914, 918,
+    922, 925, 929, 933, 937, 941, 945, 949, 953, 957, 961, 965, 969, 973, 977, 982,
+    986, 990, 994, 998, 1003, 1007, 1011, 1015, 1020, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023,
+    1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023, 1023
+};
+
+static const coshw_t LUT_COSHW[COSCOSH_LUT_SIZE] = {
+    256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256, 256,
+    256, 256, 256, 256, 256, 257, 257, 257, 257, 257, 257, 257, 257, 258, 258, 258,
+    258, 258, 258, 258, 259, 259, 259, 259, 259, 260, 260, 260, 260, 260, 261, 261,
+    261, 261, 262, 262, 262, 262, 263, 263, 263, 263, 264, 264, 264, 265, 265, 265,
+    266, 266, 266, 267, 267, 267, 268, 268, 268, 269, 269, 269, 270, 270, 270, 271,
+    271, 272, 272, 272, 273, 273, 274, 274, 275, 275, 275, 276, 276, 277, 277, 278,
+    278, 279, 279, 280, 280, 281, 281, 282, 282, 283, 283, 284, 284, 285, 286, 286,
+    287, 287, 288, 288, 289, 290, 290, 291, 291, 292, 293, 293, 294, 295, 295, 296,
+    296, 297, 298, 298, 299, 300, 301, 301, 302, 303, 303, 304, 305, 305, 306, 307,
+    308, 308, 309, 310, 311, 312, 312, 313, 314, 315, 316, 316, 317, 318, 319, 320,
+    320, 321, 322, 323, 324, 325, 326, 327, 327, 328, 329, 330, 331, 332, 333, 334,
+    335, 336, 337, 338, 339, 340, 341, 342, 343, 344, 345, 346, 347, 348, 349, 350,
+    351, 352, 353, 354, 355, 356, 357, 358, 359, 360, 362, 363, 364, 365, 366, 367,
+    368, 370, 371, 372, 373, 374, 375, 377, 378, 379, 380, 382, 383, 384, 385, 387,
+    388, 389, 390, 392, 393, 394, 396, 397, 398, 400, 401, 402, 404, 405, 406, 408,
+    409, 411, 412, 413, 415, 416, 418, 419, 421, 422, 424, 425, 426, 428, 429, 431,
+    433, 434, 436, 437, 439, 440, 442, 443, 445, 447, 448, 450, 451, 453, 455, 456,
+    458, 460, 461, 463, 465, 466, 468, 470, 472, 473, 475, 477, 479, 480, 482, 484,
+    486, 487, 489, 491, 493, 495, 497, 499, 500, 502, 504, 506, 508, 510, 512, 514,
+    516, 518, 520, 522, 524, 526, 528, 530, 532, 534, 536, 538, 540, 542, 544, 546,
+    548, 550, 553, 555, 557, 559, 561, 563, 566, 568, 570, 572, 574, 577, 579, 581,
+    584, 586, 588, 590, 593, 595, 598, 600, 602, 605, 607, 609, 612, 614, 617, 619,
+    622, 624, 627, 629, 632, 634, 637, 639, 642, 644, 647, 650, 652, 655, 657, 660,
+    663, 665, 668, 671, 674, 676, 679, 682, 685, 687, 690, 693, 696, 699, 701, 704,
+    707, 710, 713, 716, 719, 722, 725, 728, 731, 734, 737, 740, 743, 746, 749, 752,
+    755, 758, 761, 764, 768, 771, 774, 777, 780, 784, 787, 790, 793, 797, 800, 803,
+    807, 810, 813, 817, 820, 823, 827, 830, 834, 837, 841, 844, 848, 851, 855, 858,
+    862, 866, 869, 873, 876, 880, 884, 888, 891, 895, 899, 902, 906, 910, 914, 918,
+    922, 925, 929, 933, 937, 941, 945, 949, 953, 957, 961, 965, 969, 973, 977, 982,
+    986, 990, 994, 998, 1003, 1007, 1011, 1015, 1020, 1024, 1028, 1033, 1037, 1041, 1046, 1050,
+    1055, 1059, 1064, 1068, 1073, 1077, 1082, 1086, 1091, 1096, 1100, 1105, 1110, 1114, 1119, 1124,
+    1129, 1134, 1138, 1143, 1148, 1153, 1158, 1163, 1168, 1173, 1178, 1183, 1188, 1193, 1198, 1203,
+    1208, 1214, 1219, 1224, 1229, 1234, 1240, 1245, 1250, 1256, 1261, 1267, 1272, 1277, 1283, 1288,
+    1294, 1299, 1305, 1311, 1316, 1322, 1328, 1333, 1339, 1345, 1350, 1356, 1362, 1368, 1374, 1380,
+    1386, 1392, 1398, 1404, 1410, 1416, 1422, 1428, 1434, 1440, 1446, 1453, 1459, 1465, 1472, 1478,
+    1484, 1491, 1497, 1504, 1510, 1517, 1523, 1530, 1536, 1543, 1550, 1556, 1563, 1570, 1576, 1583,
+    1590, 1597, 1604, 1611, 1618, 1625, 1632, 1639, 1646, 1653, 1660, 1667, 1674, 1682, 1689, 1696,
+    1704, 1711, 1718, 1726, 1733, 1741, 1748, 1756, 1763, 1771, 1779, 1786, 1794, 1802, 1810, 1818,
+    1825, 1833, 1841, 1849, 1857, 1865, 1873, 1882, 1890, 1898, 1906, 1914, 1923, 1931, 1939, 1948,
+    1956, 1965, 1973, 1982, 1990, 1999, 2008, 2016, 2025, 2034, 2043, 2052, 2061, 2070, 2079, 2088,
+    2097, 2106, 2115, 2124, 2133, 2142, 2152, 2161, 2171, 2180, 2189, 2199, 2208, 2218, 2228, 2237,
+    2247, 2257, 2267, 2277, 2286, 2296, 2306, 2316, 2326, 2337, 2347, 2357, 2367, 2377, 2388, 2398,
+    2409, 2419, 2430, 2440, 2451, 2461, 2472, 2483, 2494, 2505, 2515, 2526, 2537, 2548, 2560, 2571,
+    2582, 2593, 2604, 2616, 2627, 2639, 2650, 2662, 2673, 2685, 2696, 2708, 2720, 2732, 2744, 2756,
+    2768, 2780, 2792, 2804, 2816, 2829, 2841, 2853, 2866, 2878, 2891, 2903, 2916, 2929, 2941, 2954,
+    2967, 2980, 2993, 3006, 3019, 3032, 3045, 3059, 3072, 3085, 3099, 3112, 3126, 3140, 3153, 3167,
+    3181, 3195, 3209, 3223, 3237, 3251, 3265, 3279, 3293, 3308, 3322, 3337, 3351, 3366, 3381, 3395,
+    3410, 3425, 3440, 3455, 3470, 3485, 3500, 3516, 3531, 3546, 3562, 3577, 3593, 3609, 3624, 3640,
+    3656, 3672, 3688, 3704, 3720, 3737, 3753, 3769, 3786, 3802, 3819, 3835, 3852, 3869, 3886, 3903,
+    3920, 3937, 3954, 3971, 3989, 4006, 4024, 4041, 4059, 4077, 4094, 4112, 4130, 4148, 4166, 4185,
+    4203, 4221, 4240, 4258, 4277, 4295, 4314, 4333, 4352, 4371, 4390, 4409, 4428, 4448, 4467, 4487,
+    4506, 4526, 4546, 4565, 4585, 4605, 4626, 4646, 4666, 4686, 4707, 4727, 4748, 4769, 4790, 4811,
+    4832, 4853, 4874, 4895, 4916, 4938, 4960, 4981, 5003, 5025, 5047, 5069, 5091, 5113, 5135, 5158,
+    5180, 5203, 5226, 5249, 5272, 5295, 5318, 5341, 5364, 5388, 5411, 5435, 5459, 5482, 5506, 5530,
+    5555, 5579, 5603, 5628, 5652, 5677, 5702, 5727, 5752, 5777, 5802, 5827, 5853, 5878, 5904, 5930,
+    5956, 5982, 6008, 6034, 6061, 6087, 6114, 6140, 6167, 6194, 6221, 6248, 6276, 6303, 6331, 6358,
+    6386, 6414, 6442, 6470, 6499, 6527, 6555, 6584, 6613, 6642, 6671, 6700, 6729, 6759, 6788, 6818,
+    6848, 6878, 6908, 6938, 6968, 6999, 7029, 7060, 7091, 7122, 7153, 7184, 7215, 7247, 7279, 7311,
+    7342, 7375, 7407, 7439, 7472, 7504, 7537, 7570, 7603, 7636, 7670, 7703, 7737, 7771, 7805, 7839,
+    7873, 7908, 7942, 7977, 8012, 8047, 8082, 8117, 8153, 8188, 8224, 8260, 8296, 8332, 8369, 8405,
+    8442, 8479, 8516, 8553, 8591, 8628, 8666, 8704, 8742, 8780, 8819, 8857, 8896, 8935, 8974, 9013,
+    9052, 9092, 9132, 9172, 9212, 9252, 9292, 9333, 9374, 9415, 9456, 9497, 9539, 9580, 9622, 9664,
+    9707, 9749, 9792, 9835, 9878, 9921, 9964, 10008, 10051, 10095, 10139, 10184, 10228, 10273, 10318, 10363,
+    10408, 10454, 10500, 10545, 10592, 10638, 10684, 10731, 10778, 10825, 10872, 10920, 10968, 11016, 11064, 11112
+};
+
+#endif
@@ -3,6 +3,7 @@
 
 #include "ap_int.h"
 #include "ap_fixed.h"
+#include "native_types.h"
 #include <cstdint>
 #include <fstream>
 #include "math.h"
@@ -13,29 +14,40 @@
 #define NPUPPI_SEL 7                      // Number of selected non-masked ordered candidates
 #define NTRIPLETS 8                       // Number of triplets
 
+// Arithmetic types are arith::ap_* : the ap_* library, or its native-integer
+// emulation with -DW3P_NATIVE_TYPES (fast C simulation, see native_types.h)
+
 // Index type - should always be able to cover [0,NPUPPI_MAX] !
-typedef ap_uint<8> idx_t; // [0,255]
+typedef arith::ap_uint<8> idx_t; // [0,255]
 
 // DeltaR type
-typedef ap_uint<24> dr2_t;
+typedef arith::ap_uint<24> dr2_t;
 
 // Cosine and Hyperbolic-Cosine types
-typedef ap_int<10> cos_t;
-typedef ap_uint<10> cosh_t;
+typedef arith::ap_int<10> cos_t;
+typedef arith::ap_uint<10> cosh_t;
+typedef arith::ap_uint<14> coshw_t; // up to cosh(COSCOSH_LUT_SIZE-1 LSB) = 43.3, for the triplet masses
 
 #define COSCOSH_LSB 256
 #define COSCOSH_LUT_SIZE 1024
 
 // Invariant mass types
-typedef ap_ufixed<15,12,AP_RND,AP_SAT> mass_t; // [0, 4095] with LSB = 0.125 GeV
+typedef arith::ap_ufixed<15,12,AP_RND,AP_SAT> mass_t; // [0, 4095] with LSB = 0.125 GeV
+
+// Squared pair and triplet masses and triplet pT, in GeV^2 (massless candidates)
+typedef arith::ap_ufixed<20,18,AP_TRN,AP_SAT> mass2_t; // [0, 262143] with LSB = 0.25 GeV^2
+
+// m(3pi) window of the triplet veto (GeV), as the offline preselection
+#define TRIPLET_MASS_MIN 50
+#define TRIPLET_MASS_MAX 110
 
 // Puppi class
 struct Puppi {
     // data types and constants
-    typedef ap_ufixed<14,12,AP_RND,AP_SAT> pt_t;
-    typedef ap_int<12> eta_t;
-    typedef ap_int<11> phi_t;
-    typedef ap_int<10> z0_t;
+    typedef arith::ap_ufixed<14,12,AP_RND,AP_SAT> pt_t;
+    typedef arith::ap_int<12> eta_t;
+    typedef arith::ap_int<11> phi_t;
+    typedef arith::ap_int<10> z0_t;
     static constexpr int INT_PI = 360;
     static constexpr int INT_2PI = 2*INT_PI;
     static constexpr float ETAPHI_LSB = M_PI/(2*INT_PI); // pi / 720 = 1/4 deg = 3.14159 / 720 = 0.0043633194
@@ -47,7 +59,7 @@ struct Puppi {
     pt_t hwPt;
     eta_t hwEta;
     phi_t hwPhi;
-    ap_uint<3> hwID;
+    arith::ap_uint<3> hwID;
     z0_t hwZ0;
 
     // pack and unpack
@@ -124,4 +136,29 @@ struct Puppi {
     }
 };
 
+// Kinematics of a pair of selected candidates (get_pair_matrix): differences are the
+// first candidate minus the second one, dphi folded into [-INT_PI, INT_PI] and cos, cosh
+// the LUT values of get_pair_mass; cosphi is the cosine of the azimuthal angle between
+// the candidates (INT_2PI is pi in phi units, the fold changes the sign of cos) and
+// coshw the cosh of deta without the cosh_t saturation
+struct PuppiPair {
+    typedef arith::ap_int<Puppi::phi_t::width+1> dphi_t;
+    typedef arith::ap_int<Puppi::eta_t::width+1> deta_t;
+    typedef arith::ap_int<Puppi::z0_t::width+1> dz_t;
+
+    dphi_t dphi;
+    deta_t deta;
+    cos_t cos;
+    cos_t cosphi;
+    cosh_t cosh;
+    coshw_t coshw;
+    mass_t mass;
+    mass2_t mass2;
+    dr2_t dr2;
+    dz_t dz;
+};
+
+// Sort key type: hwPt bits above the inverted candidate index (see make_sort_key in pipeline.h)
+typedef arith::ap_uint<Puppi::pt_t::width + idx_t::width> sortkey_t;
+
 #endif
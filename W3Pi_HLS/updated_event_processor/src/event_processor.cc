@@ -1,7 +1,19 @@
 #include "event_processor.h"
 #include "bitonic_hybrid.h"
+#include "coscosh_lut.h"
 
 // ------------------------------------------------------------------
+// Selections of one L1Puppi object: true if it has to be masked
+bool is_masked (const Puppi & p)
+{
+    #pragma HLS inline
+    //bool badPt  = (p.hwPt < 3.25 );
+    bool badEta = (p.hwEta < -Puppi::ETA_CUT || p.hwEta > Puppi::ETA_CUT);
+    bool badID  = (p.hwID < 2 || p.hwID > 5);
+    //return (badPt || badEta || badID);
+    return (badEta || badID);
+}
+
 // Masker: mask L1Puppi objects that don't pass selections
 void masker (const Puppi input[NPUPPI_MAX], ap_uint<NPUPPI_MAX> & masked)
 {
@@ -14,11 +26,7 @@ void masker (const Puppi input[NPUPPI_MAX], ap_uint<NPUPPI_MAX> & masked)
     LOOP_MASKER_FILL: for (unsigned int i = 0; i < NPUPPI_MAX; i++)
     {
         #pragma HLS UNROLL
-        //bool badPt  = (input[i].hwPt < 3.25 );
-        bool badEta = (input[i].hwEta < -Puppi::ETA_CUT || input[i].hwEta > Puppi::ETA_CUT);
-        bool badID  = (input[i].hwID < 2 || input[i].hwID > 5);
-        //masked[i] = (badPt || badEta || badID);
-        masked[i] = (badEta || badID);
+        masked[i] = is_masked(input[i]);
     }
 }
 
@@ -41,406 +49,60 @@ void slimmer (const Puppi input[NPUPPI_MAX], const ap_uint<NPUPPI_MAX> masked, P
 
 // ------------------------------------------------------------------
 // Sort slimmed candidates by pT using bitonicSort from bitonic_hybrid.h
-// Split and order 16 arrays of 13 candidates (16 x 13 = 208)
-void orderer7 (const Puppi slimmed[NPUPPI_MAX],
-               Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-               Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-               Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-               Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-               Puppi ordered9 [NSPLITS], Puppi ordered10[NSPLITS],
-               Puppi ordered11[NSPLITS], Puppi ordered12[NSPLITS],
-               Puppi ordered13[NSPLITS], Puppi ordered14[NSPLITS],
-               Puppi ordered15[NSPLITS], Puppi ordered16[NSPLITS])
-{
-    #pragma HLS ARRAY_PARTITION variable=slimmed   complete
-    #pragma HLS ARRAY_PARTITION variable=ordered1  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered2  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered3  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered4  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered5  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered6  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered7  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered8  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered9  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered10 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered11 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered12 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered13 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered14 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered15 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered16 complete
-
-    // Split in 8 arrays
-    LOOP_ORDERER7_SPLIT: for (unsigned int i=0; i < NSPLITS; i++)
-    {
-        #pragma HLS UNROLL
-        ordered1 [i] = slimmed[i];
-        ordered2 [i] = slimmed[i+NSPLITS];
-        ordered3 [i] = slimmed[i+2*NSPLITS];
-        ordered4 [i] = slimmed[i+3*NSPLITS];
-        ordered5 [i] = slimmed[i+4*NSPLITS];
-        ordered6 [i] = slimmed[i+5*NSPLITS];
-        ordered7 [i] = slimmed[i+6*NSPLITS];
-        ordered8 [i] = slimmed[i+7*NSPLITS];
-        ordered9 [i] = slimmed[i+8*NSPLITS];
-        ordered10[i] = slimmed[i+9*NSPLITS];
-        ordered11[i] = slimmed[i+10*NSPLITS];
-        ordered12[i] = slimmed[i+11*NSPLITS];
-        ordered13[i] = slimmed[i+12*NSPLITS];
-        ordered14[i] = slimmed[i+13*NSPLITS];
-        ordered15[i] = slimmed[i+14*NSPLITS];
-        ordered16[i] = slimmed[i+15*NSPLITS];
-    }
-
-    // Sort arrays
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered1  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered2  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered3  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered4  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered5  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered6  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered7  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered8  , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered9 , 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered10, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered11, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered12, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered13, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered14, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered15, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, false>::run(ordered16, 0);
-}
-
-// Split and order 8 arrays of 26 candidates (8 x 26 = 208)
-void orderer7bis (const Puppi slimmed[NPUPPI_MAX],
-                  Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                  Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                  Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                  Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS])
-{
-    #pragma HLS ARRAY_PARTITION variable=slimmed   complete
-    #pragma HLS ARRAY_PARTITION variable=ordered1  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered2  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered3  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered4  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered5  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered6  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered7  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered8  complete
-
-    // Split in 8 arrays
-    LOOP_ORDERER7_SPLIT: for (unsigned int i=0; i < NSPLITS; i++)
-    {
-        #pragma HLS UNROLL
-        ordered1[i] = slimmed[i];
-        ordered2[i] = slimmed[i+NSPLITS];
-        ordered3[i] = slimmed[i+2*NSPLITS];
-        ordered4[i] = slimmed[i+3*NSPLITS];
-        ordered5[i] = slimmed[i+4*NSPLITS];
-        ordered6[i] = slimmed[i+5*NSPLITS];
-        ordered7[i] = slimmed[i+6*NSPLITS];
-        ordered8[i] = slimmed[i+7*NSPLITS];
-    }
-
-    // Sort arrays
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered1, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered2, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered3, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered4, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered5, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered6, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered7, 0);
-    hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered8, 0);
-}
-
-// Sort in pairs the split arrays
+// Split and order NSUBARR arrays of NSPLITS candidates (orderer<> in pipeline.h)
 void orderer7f (const Puppi slimmed[NPUPPI_MAX], Puppi ordered[NSUBARR][NSPLITS])
 {
     #pragma HLS ARRAY_PARTITION variable=slimmed complete
     #pragma HLS ARRAY_PARTITION variable=ordered complete dim=2
 
-    // Split in 8 arrays
-    LOOP_ORDERER7E_FILL: for (unsigned int i=0; i < NSPLITS; i++)
-    {
-        #pragma HLS UNROLL
-        ordered[0][i] = slimmed[i];
-        ordered[1][i] = slimmed[i+NSPLITS];
-        ordered[2][i] = slimmed[i+2*NSPLITS];
-        ordered[3][i] = slimmed[i+3*NSPLITS];
-        ordered[4][i] = slimmed[i+4*NSPLITS];
-        ordered[5][i] = slimmed[i+5*NSPLITS];
-        ordered[6][i] = slimmed[i+6*NSPLITS];
-        ordered[7][i] = slimmed[i+7*NSPLITS];
-    }
-
-    // Sort the 8 arrays
-    LOOP_ORDERER7E_SORT: for (unsigned int i=0; i < NSUBARR / 2; i++)
-    {
-        hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered[i]  , 0);
-        hybridBitonicSort::bitonicSorter<Puppi, NSPLITS, 0, true>::run(ordered[i+1], 0);
-    }
+    orderer<NPUPPI_MAX, NSUBARR>(slimmed, ordered);
 }
 
 // ------------------------------------------------------------------
-// Utils for merge-sorting
-
-// get_bitonic_sequence
-void get_bitonic_sequenceA(const Puppi in1[NSPLITS], const Puppi in2[NSPLITS], Puppi bitonic[2*NSPLITS]) {
-    //#pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=bitonic complete
-    make_bitonic_loop: for(int id = 0, ia=NSPLITS-1; id<NSPLITS; id++, ia--)
-    {
-        #pragma HLS UNROLL
-        bitonic[id] = in1[ia];
-        bitonic[id+(NSPLITS)] = in2[id];
-    }
-}
-
-void get_bitonic_sequenceB(const Puppi in1[2*NSPLITS], const Puppi in2[2*NSPLITS], Puppi bitonic[4*NSPLITS]) {
-    //#pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=bitonic complete
-    make_bitonic_loop: for(int id = 0, ia=2*NSPLITS-1; id<2*NSPLITS; id++, ia--)
-    {
-        #pragma HLS UNROLL
-        bitonic[id] = in1[ia];
-        bitonic[id+(2*NSPLITS)] = in2[id];
-    }
-}
-
-void get_bitonic_sequenceC(const Puppi in1[4*NSPLITS], const Puppi in2[4*NSPLITS], Puppi bitonic[8*NSPLITS]) {
-    //#pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=bitonic complete
-    make_bitonic_loop: for(int id = 0, ia=4*NSPLITS-1; id<4*NSPLITS; id++, ia--)
-    {
-        #pragma HLS UNROLL
-        bitonic[id] = in1[ia];
-        bitonic[id+(4*NSPLITS)] = in2[id];
-    }
-}
-
-void get_bitonic_sequenceD(const Puppi in1[8*NSPLITS], const Puppi in2[8*NSPLITS], Puppi bitonic[16*NSPLITS]) {
-    #pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=bitonic complete
-    make_bitonic_loop: for(int id = 0, ia=8*NSPLITS-1; id<8*NSPLITS; id++, ia--)
-    {
-        #pragma HLS UNROLL
-        bitonic[id] = in1[ia];
-        bitonic[id+(8*NSPLITS)] = in2[id];
-    }
-}
-
-// merge_sort
-void merge_sortA(const Puppi in1[NSPLITS], const Puppi in2[NSPLITS], Puppi sorted_out[2*NSPLITS]) {
-    //#pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=sorted_out complete
-    get_bitonic_sequenceA(in1, in2, sorted_out);
-    hybridBitonicSort::bitonicMerger<Puppi, 2*NSPLITS, 0>::run(sorted_out, 0);
-}
-
-void merge_sortB(const Puppi in1[2*NSPLITS], const Puppi in2[2*NSPLITS], Puppi sorted_out[4*NSPLITS]) {
-    //#pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=sorted_out complete
-    get_bitonic_sequenceB(in1, in2, sorted_out);
-    hybridBitonicSort::bitonicMerger<Puppi, 4*NSPLITS, 0>::run(sorted_out, 0);
-}
-
-void merge_sortC(const Puppi in1[4*NSPLITS], const Puppi in2[4*NSPLITS], Puppi sorted_out[8*NSPLITS]) {
-    //#pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=sorted_out complete
-    get_bitonic_sequenceC(in1, in2, sorted_out);
-    hybridBitonicSort::bitonicMerger<Puppi, 8*NSPLITS, 0>::run(sorted_out, 0);
-}
-
-void merge_sortD(const Puppi in1[8*NSPLITS], const Puppi in2[8*NSPLITS], Puppi sorted_out[16*NSPLITS]) {
-    #pragma HLS inline
-    #pragma HLS array_partition variable=in1 complete
-    #pragma HLS array_partition variable=in2 complete
-    #pragma HLS array_partition variable=sorted_out complete
-    get_bitonic_sequenceD(in1, in2, sorted_out);
-    hybridBitonicSort::bitonicMerger<Puppi, 16*NSPLITS, 0>::run(sorted_out, 0);
-}
-
-// ------------------------------------------------------------------
-// Merger: merge ordered arrays with bitonicMerger
-void merger (Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-             Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-             Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-             Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-             Puppi ordered9 [NSPLITS], Puppi ordered10[NSPLITS],
-             Puppi ordered11[NSPLITS], Puppi ordered12[NSPLITS],
-             Puppi ordered13[NSPLITS], Puppi ordered14[NSPLITS],
-             Puppi ordered15[NSPLITS], Puppi ordered16[NSPLITS],
-             Puppi merged[NPUPPI_MAX])
-{
-    #pragma HLS ARRAY_PARTITION variable=ordered1  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered2  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered3  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered4  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered5  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered6  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered7  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered8  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered9  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered10 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered11 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered12 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered13 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered14 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered15 complete
-    #pragma HLS ARRAY_PARTITION variable=ordered16 complete
-    #pragma HLS ARRAY_PARTITION variable=merged    complete
-
-    // Recursively merge and sort in pairs
-    // Step 1
-    Puppi merge1[2*NSPLITS];
-    merge_sortA(ordered1, ordered2, merge1);
-
-    Puppi merge2[2*NSPLITS];
-    merge_sortA(ordered3, ordered4, merge2);
-
-    Puppi merge3[2*NSPLITS];
-    merge_sortA(ordered5, ordered6, merge3);
-
-    Puppi merge4[2*NSPLITS];
-    merge_sortA(ordered7, ordered8, merge4);
-
-    Puppi merge5[2*NSPLITS];
-    merge_sortA(ordered9, ordered10, merge5);
-
-    Puppi merge6[2*NSPLITS];
-    merge_sortA(ordered11, ordered12, merge6);
-
-    Puppi merge7[2*NSPLITS];
-    merge_sortA(ordered13, ordered14, merge7);
-
-    Puppi merge8[2*NSPLITS];
-    merge_sortA(ordered15, ordered16, merge8);
-
-    // Step 2
-    Puppi merge9[4*NSPLITS];
-    merge_sortB(merge1, merge2, merge9);
-
-    Puppi merge10[4*NSPLITS];
-    merge_sortB(merge3, merge4, merge10);
-
-    Puppi merge11[4*NSPLITS];
-    merge_sortB(merge5, merge6, merge11);
-
-    Puppi merge12[4*NSPLITS];
-    merge_sortB(merge7, merge8, merge12);
-
-    // Step 3
-    Puppi merge13[8*NSPLITS];
-    merge_sortC(merge9, merge10, merge13);
-
-    Puppi merge14[8*NSPLITS];
-    merge_sortC(merge11, merge12, merge14);
-
-    // Final
-    merge_sortD(merge13, merge14, merged);
-}
-
-// Same as merger but using 8 arrays of 26 elements
-void merger7bis (Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                 Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                 Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                 Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-                 Puppi merged[NPUPPI_MAX])
-{
-    #pragma HLS ARRAY_PARTITION variable=ordered1  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered2  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered3  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered4  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered5  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered6  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered7  complete
-    #pragma HLS ARRAY_PARTITION variable=ordered8  complete
-    #pragma HLS ARRAY_PARTITION variable=merged    complete
-
-    // Recursively merge and sort in pairs
-    // Step 1
-    Puppi merge1[2*NSPLITS];
-    merge_sortA(ordered1, ordered2, merge1);
-
-    Puppi merge2[2*NSPLITS];
-    merge_sortA(ordered3, ordered4, merge2);
-
-    Puppi merge3[2*NSPLITS];
-    merge_sortA(ordered5, ordered6, merge3);
-
-    Puppi merge4[2*NSPLITS];
-    merge_sortA(ordered7, ordered8, merge4);
-
-    // Step 2
-    Puppi merge5[4*NSPLITS];
-    merge_sortB(merge1, merge2, merge5);
-
-    Puppi merge6[4*NSPLITS];
-    merge_sortB(merge3, merge4, merge6);
-
-    // Final
-    merge_sortC(merge5, merge6, merged);
-}
-
-// Same as merger7bis but starting from orderer7f
+// Merger: merge ordered arrays with bitonicMerger (merger<> in pipeline.h)
 void merger7f (Puppi ordered[NSUBARR][NSPLITS], Puppi merged[NPUPPI_MAX])
 {
     #pragma HLS ARRAY_PARTITION variable=ordered complete dim=2
     #pragma HLS ARRAY_PARTITION variable=merged  complete
 
-    // original                                                       // --> v0
-    //#pragma HLS ALLOCATION instances=merge_sortA limit=1 function   // --> v1 |
-    //#pragma HLS ALLOCATION instances=merge_sortA limit=2 function   // --> v2 |
-    //#pragma HLS ALLOCATION instances=merge_sortB limit=1 function   // --> v3 |-> all the same v1-4
-    //#pragma HLS ALLOCATION instances=merge_sortA limit=1 function   // --> v4 |
-    //#pragma HLS ALLOCATION instances=merge_sortB limit=1 function   //     v4 |
-    // remove inlinings from merge_sortA                              // --> v5
-    //#pragma HLS ALLOCATION instances=merge_sortA limit=1 function   // + remove inlinings from merge_sortA --> v6 // same as v5
-    // remove inlinings from merge_sortB                              // --> v7
-    // remove inlinings from merge_sortA and merge_sortB              // --> v8
-    // remove inlinings from merge_sortC                              // --> v9  // almost identical to v1-4
-    // remove inlinings from merge_sortA, merge_sortB and merge_sortC // --> v10 // almost identical to v8
+    // History of the 8 x 26 merger, with merge_sortA/B/C = the levels 0/1/2 of the merge tree,
+    // now MergeTree<2, 0, MergePolicy<INLINE_OFF, SHARED>> as last template argument of merger<>:
+    // original                                                       // --> v0  MergePolicy<0, 0>
+    // ALLOCATION on the inlined merge_sortA/B (no effect)            // --> v1-4 (all the same)
+    // remove inlinings from merge_sortA                              // --> v5  MergePolicy<1, 0>
+    // + ALLOCATION limit=1 on merge_sortA                            // --> v6  MergePolicy<0, 1> // same as v5
+    // remove inlinings from merge_sortB                              // --> v7  MergePolicy<2, 0>
+    // remove inlinings from merge_sortA and merge_sortB              // --> v8  MergePolicy<3, 0>
+    // remove inlinings from merge_sortC                              // --> v9  MergePolicy<4, 0> // almost identical to v1-4
+    // remove inlinings from merge_sortA, merge_sortB and merge_sortC // --> v10 MergePolicy<7, 0> // almost identical to v8
     // remove inlinings from all merge_sort and all bitonic_sequence  // --> v11 // best so far
     // next:
-    //   - test not inlining + ALLOCATION combination
+    //   - test not inlining + ALLOCATION combination (e.g. MergePolicy<6, 1>)
 
-    // Recursively merge and sort in pairs
-    // Step 1
-    Puppi merge1[2*NSPLITS];
-    merge_sortA(ordered[0], ordered[1], merge1);
-
-    Puppi merge2[2*NSPLITS];
-    merge_sortA(ordered[2], ordered[3], merge2);
-
-    Puppi merge3[2*NSPLITS];
-    merge_sortA(ordered[4], ordered[5], merge3);
+    merger<NPUPPI_MAX, NSUBARR>(ordered, merged);
+}
 
-    Puppi merge4[2*NSPLITS];
-    merge_sortA(ordered[6], ordered[7], merge4);
+// Pruned merger: only the NPUPPI_SEL leading candidates of orderer7f + merger7f, every merge
+// truncated to its top NPUPPI_SEL (SelectionMergeTree in pipeline.h), 8 x 7 = 56 -> 7.
+// Sorts the keys as sorter7f (ties in input order), so it starts from the slimmed candidates
+void merger7f_pruned (const Puppi slimmed[NPUPPI_MAX], Puppi merged[NPUPPI_SEL])
+{
+    #pragma HLS ARRAY_PARTITION variable=slimmed complete
+    #pragma HLS ARRAY_PARTITION variable=merged  complete
 
-    // Step 2
-    Puppi merge5[4*NSPLITS];
-    merge_sortB(merge1, merge2, merge5);
+    sortkey_t sorted[NPUPPI_SEL];
+    sort_keys<NPUPPI_MAX, NSUBARR, SubArrayNetwork, SelectionMergeTree>(slimmed, sorted);
+    gather<NPUPPI_MAX, NPUPPI_SEL>(slimmed, sorted, merged);
+}
 
-    Puppi merge6[4*NSPLITS];
-    merge_sortB(merge3, merge4, merge6);
+// ------------------------------------------------------------------
+// Sorter: sort keys of the candidates (sort_keys<> in pipeline.h), same geometry as orderer7f + merger7f
+void sorter7f (const Puppi slimmed[NPUPPI_MAX], sortkey_t sorted[NPUPPI_MAX])
+{
+    #pragma HLS ARRAY_PARTITION variable=slimmed complete
+    #pragma HLS ARRAY_PARTITION variable=sorted  complete
 
-    // Final
-    merge_sortC(merge5, merge6, merged);
+    sort_keys<NPUPPI_MAX, NSUBARR>(slimmed, sorted);
 }
 
 // ------------------------------------------------------------------
@@ -457,6 +119,29 @@ void selector(const Puppi merged[NPUPPI_MAX], Puppi selected[NPUPPI_SEL])
     }
 }
 
+// Select first NPUPPI_SEL candidates from the sorted keys
+void selector7f(const Puppi slimmed[NPUPPI_MAX], const sortkey_t sorted[NPUPPI_MAX], Puppi selected[NPUPPI_SEL])
+{
+    #pragma HLS ARRAY_PARTITION variable=slimmed complete
+    #pragma HLS ARRAY_PARTITION variable=sorted complete
+    #pragma HLS ARRAY_PARTITION variable=selected complete
+
+    gather<NPUPPI_MAX, NPUPPI_SEL>(slimmed, sorted, selected);
+}
+
+// ------------------------------------------------------------------
+// Top-K: select the NPUPPI_SEL leading candidates without sorting all of them
+// (select_keys<> in pipeline.h), same output as sorter7f + selector7f
+void topk7f(const Puppi slimmed[NPUPPI_MAX], Puppi selected[NPUPPI_SEL])
+{
+    #pragma HLS ARRAY_PARTITION variable=slimmed complete
+    #pragma HLS ARRAY_PARTITION variable=selected complete
+
+    sortkey_t top[NPUPPI_SEL];
+    select_keys<NPUPPI_MAX, NPUPPI_SEL>(slimmed, top);
+    gather<NPUPPI_MAX, NPUPPI_SEL>(slimmed, top, selected);
+}
+
 
 // ------------------------------------------------------------------
 // Get maximum deltaVz
@@ -487,7 +172,7 @@ inline float hwDr2ToDr (dr2_t dr2)
     return std::sqrt(dr2.to_int()*Puppi::ETAPHI_LSB*Puppi::ETAPHI_LSB);
 }
 
-ap_int<Puppi::eta_t::width+1> deltaEta (Puppi::eta_t eta1, Puppi::eta_t eta2)
+arith::ap_int<Puppi::eta_t::width+1> deltaEta (Puppi::eta_t eta1, Puppi::eta_t eta2)
 {
     #pragma HLS latency min=1
     #pragma HLS inline off
@@ -562,19 +247,18 @@ void _lut_cos_init(cos_t table_cos[COSCOSH_LUT_SIZE])
     }
 }
 
-// Get cos value from LUT
+// Get cos value from the LUT_COS ROM (coscosh_lut.h, generated from _lut_cos_init)
+// A single ROM with one read port per get_pair_mass instance
 cos_t get_cos_phi (Puppi::phi_t phi)
 {
-    // Declare and fill cos LUT
-    cos_t _table_cos[COSCOSH_LUT_SIZE];
-    _lut_cos_init(_table_cos);
+    #pragma HLS BIND_STORAGE variable=LUT_COS type=rom_np impl=lutram
 
     // Change phi to only positive value
     int iphi = phi;
     if (phi < 0) iphi = -iphi;
 
     // Return cos phi value
-    return _table_cos[iphi];
+    return LUT_COS[iphi];
 }
 
 // Declare and fill hyperbolic cosine LUT
@@ -596,25 +280,50 @@ void _lut_cosh_init(cosh_t table_cosh[COSCOSH_LUT_SIZE])
     }
 }
 
-// Get cosh value from LUT
+// Same as _lut_cosh_init saturated to coshw_t (LUT_COSH is LUT_COSHW saturated to cosh_t)
+void _lut_coshw_init(coshw_t table_coshw[COSCOSH_LUT_SIZE])
+{
+    for (int i = 0; i < COSCOSH_LUT_SIZE; ++i)
+    {
+        float alpha = Puppi::ETAPHI_LSB * i;
+        int ich = cosh(alpha) * COSCOSH_LSB;
+        if (ich > (1 << coshw_t::width) - 1) ich = (1 << coshw_t::width) - 1;
+        table_coshw[i] = ich;
+    }
+}
+
+// Get cosh value from the LUT_COSH ROM (coscosh_lut.h, generated from _lut_cosh_init)
 cosh_t get_cosh_eta (Puppi::eta_t eta)
 {
-    // Declare and fill cos LUT
-    cosh_t _table_cosh[COSCOSH_LUT_SIZE];
-    _lut_cosh_init(_table_cosh);
+    #pragma HLS BIND_STORAGE variable=LUT_COSH type=rom_np impl=lutram
 
     // Change eta to only positive value
     int ieta = eta;
     if (eta < 0) ieta = -ieta;
 
+    // |deta| beyond the table: the last entry, already saturated
+    if (ieta > COSCOSH_LUT_SIZE-1) ieta = COSCOSH_LUT_SIZE-1;
+
     // Return cosh eta value
-    return _table_cosh[ieta];
+    return LUT_COSH[ieta];
+}
+
+// Same as get_cosh_eta from the LUT_COSHW ROM
+coshw_t get_coshw_eta (Puppi::eta_t eta)
+{
+    #pragma HLS BIND_STORAGE variable=LUT_COSHW type=rom_np impl=lutram
+
+    int ieta = eta;
+    if (eta < 0) ieta = -ieta;
+    if (ieta > COSCOSH_LUT_SIZE-1) ieta = COSCOSH_LUT_SIZE-1;
+
+    return LUT_COSHW[ieta];
 }
 
 // ------------------------------------------------------------------
 // Invariant mass quared of pair of particles
 // m^2 = 2 * pT1 * pT2 * ( cosh(eta1 - eta2) - cos(phi1 - phi2) )
-// FIXME: this can possibly return a negative value??
+// cosh - cos >= 0: both LUTs truncate towards zero, so LUT_COSH >= COSCOSH_LSB >= LUT_COS
 mass_t get_pair_mass (const Puppi & p1, const Puppi & p2)
 {
     // Get dPhi and dEta
@@ -663,28 +372,181 @@ void get_triplet_inputs (const Puppi selected[NPUPPI_SEL], idx_t idx0, idx_t idx
 }
 
 // ------------------------------------------------------------------
-// Get all event inputs
-// - 8 triplets from: 5 from 1st+2nd, 2 from 1st+3rd and 1 from 2nd+3rd:
-// (0,1,2)-(0,1,3)-(0,1,4)-(0,1,5)-(0,1,6)-(0,2,3)-(0,2,3)-(1,2,3)
-void get_event_inputs (const Puppi selected[NPUPPI_SEL], w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features])
+// cos/cosh values of the LUTs as fixed point: same bits, with log2(COSCOSH_LSB) fractional bits
+static_assert(COSCOSH_LSB == 256, "cos/cosh LUT values are expected with 8 fractional bits");
+
+inline arith::ap_fixed<cos_t::width, cos_t::width-8> cos_value (cos_t cos)
+{
+    #pragma HLS inline
+    arith::ap_fixed<cos_t::width, cos_t::width-8> value;
+    value(cos_t::width-1, 0) = cos(cos_t::width-1, 0);
+    return value;
+}
+
+// Squared mass of a pair of massless candidates, 2 pT1 pT2 (cosh - cos), in GeV^2
+inline mass2_t get_pair_mass2 (Puppi::pt_t pt1, Puppi::pt_t pt2, cos_t cos, coshw_t cosh)
+{
+    #pragma HLS inline
+    arith::ap_int<coshw_t::width+2> diff = cosh - cos;
+    arith::ap_fixed<coshw_t::width+2, coshw_t::width+2-8> coscosh;
+    coscosh(coshw_t::width+1, 0) = diff(coshw_t::width+1, 0);
+    return 2 * pt1 * pt2 * coscosh;
+}
+
+// ------------------------------------------------------------------
+// Pair quantities of all the selected candidates, computed once per pair (i < j) and
+// mirrored: pairs[i][j] is candidate i minus candidate j, the diagonal is a null pair
+void get_pair_matrix (const Puppi selected[NPUPPI_SEL], PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL])
 {
+    #pragma HLS inline
     #pragma HLS ARRAY_PARTITION variable=selected complete
-    #pragma HLS ARRAY_PARTITION variable=BDT_inputs complete dim=0
+    #pragma HLS ARRAY_PARTITION variable=pairs complete dim=0
 
-    // 5 triplets from 1st+2nd pivots
-    LOOP_EVENT_INPUTS: for (unsigned int i = 0; i < NTRIPLETS-3; i++)
+    LOOP_PAIRS_I: for (unsigned int i = 0; i < NPUPPI_SEL; i++)
     {
         #pragma HLS unroll
-        idx_t third_idx = i + 2; // 2 pivots excluded
-        get_triplet_inputs(selected, 0, 1, i, BDT_inputs[i]);
+        PuppiPair & null = pairs[i][i];
+        null.dphi = 0;
+        null.deta = 0;
+        null.cos  = COSCOSH_LSB;
+        null.cosphi = COSCOSH_LSB;
+        null.cosh = COSCOSH_LSB;
+        null.coshw = COSCOSH_LSB;
+        null.mass = 0;
+        null.mass2 = 0;
+        null.dr2  = 0;
+        null.dz   = 0;
+
+        LOOP_PAIRS_J: for (unsigned int j = i+1; j < NPUPPI_SEL; j++)
+        {
+            #pragma HLS unroll
+            PuppiPair & p = pairs[i][j];
+
+            // Same arithmetic as get_pair_mass and deltaR2
+            p.dphi = selected[i].hwPhi - selected[j].hwPhi;
+            bool folded = p.dphi > Puppi::INT_PI || p.dphi < -Puppi::INT_PI;
+            if (p.dphi > Puppi::INT_PI) p.dphi -= Puppi::INT_2PI;
+            else if (p.dphi < -Puppi::INT_PI) p.dphi += Puppi::INT_2PI;
+            p.deta = selected[i].hwEta - selected[j].hwEta;
+            p.cos  = get_cos_phi(p.dphi);
+            p.cosphi = folded ? cos_t(-p.cos) : p.cos;
+            // one cosh ROM: the get_cosh_eta value is the coshw_t one saturated to cosh_t
+            p.coshw = get_coshw_eta(p.deta);
+            p.cosh = (p.coshw > COSCOSH_LUT_SIZE-1) ? cosh_t(COSCOSH_LUT_SIZE-1) : cosh_t(p.coshw);
+            p.mass = 2 * selected[i].hwPt * selected[j].hwPt * (p.cosh - p.cos);
+            p.mass2 = get_pair_mass2(selected[i].hwPt, selected[j].hwPt, p.cosphi, p.coshw);
+            p.dr2  = p.dphi*p.dphi + p.deta*p.deta;
+            p.dz   = selected[i].hwZ0 - selected[j].hwZ0;
+
+            // j minus i: only the differences change sign
+            PuppiPair & q = pairs[j][i];
+            q = p;
+            q.dphi = -p.dphi;
+            q.deta = -p.deta;
+            q.dz   = -p.dz;
+        }
     }
+}
 
-    // 2 triplets from 1st+3rd pivots
-    get_triplet_inputs(selected, 0, 2, 3, BDT_inputs[5]);
-    get_triplet_inputs(selected, 0, 2, 4, BDT_inputs[6]);
+// Same features as get_triplet_inputs, gathered from the pair matrix
+void gather_triplet_inputs (const Puppi selected[NPUPPI_SEL], const PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL],
+                            idx_t idx0, idx_t idx1, idx_t idx2, w3p_bdt::input_t BDT_inputs[w3p_bdt::n_features])
+{
+    #pragma HLS inline
 
-    // 1 triplet from 2nd+3rd pivots
-    get_triplet_inputs(selected, 1, 2, 3, BDT_inputs[7]);
+    // dVz as get_max_dVz, dR2 as get_min_deltaR2
+    Puppi::z0_t dVz_01 = pairs[idx0][idx1].dz;
+    Puppi::z0_t dVz_02 = pairs[idx0][idx2].dz;
+    Puppi::z0_t dVz_12 = pairs[idx1][idx2].dz;
+    dr2_t dr2_01 = pairs[idx0][idx1].dr2;
+    dr2_t dr2_02 = pairs[idx0][idx2].dr2;
+    dr2_t dr2_12 = pairs[idx1][idx2].dr2;
+
+    // Fill BDT input for triplet
+    BDT_inputs[0]  = selected[idx2].hwPt;
+    BDT_inputs[1]  = selected[idx1].hwPt;
+    BDT_inputs[2]  = pairs[idx0][idx1].mass;
+    BDT_inputs[3]  = selected[idx0].charge() + selected[idx1].charge() + selected[idx2].charge();
+    BDT_inputs[4]  = pairs[idx0][idx2].dz;
+    BDT_inputs[5]  = selected[idx0].hwPt;
+    BDT_inputs[6]  = selected[idx0].hwPt + selected[idx1].hwPt + selected[idx2].hwPt;
+    BDT_inputs[7]  = pairs[idx0][idx2].mass;
+    BDT_inputs[8]  = std::max(dVz_01, std::max(dVz_02, dVz_12));
+    BDT_inputs[9]  = std::min(dr2_01, std::min(dr2_02, dr2_12));
+    BDT_inputs[10] = selected[idx2].hwEta;
+}
+
+// Squared mass and squared pT of a triplet of massless candidates, from the pair matrix:
+// m^2_012 = m^2_01 + m^2_02 + m^2_12 and pT^2 = sum pT_i^2 + 2 sum_i<j pT_i pT_j cos(dphi_ij)
+void get_triplet_kinematics (const Puppi selected[NPUPPI_SEL], const PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL],
+                             idx_t idx0, idx_t idx1, idx_t idx2, mass2_t & m2, mass2_t & pt2)
+{
+    #pragma HLS inline
+
+    m2 = pairs[idx0][idx1].mass2 + pairs[idx0][idx2].mass2 + pairs[idx1][idx2].mass2;
+
+    Puppi::pt_t pt0 = selected[idx0].hwPt, pt1 = selected[idx1].hwPt, ptx = selected[idx2].hwPt;
+    pt2 = pt0*pt0 + pt1*pt1 + ptx*ptx + 2 * (pt0 * pt1 * cos_value(pairs[idx0][idx1].cosphi)
+                                          + pt0 * ptx * cos_value(pairs[idx0][idx2].cosphi)
+                                          + pt1 * ptx * cos_value(pairs[idx1][idx2].cosphi));
+}
+
+// True if the triplet mass is in [TRIPLET_MASS_MIN, TRIPLET_MASS_MAX]
+inline bool in_mass_window (mass2_t m2)
+{
+    #pragma HLS inline
+    return m2 >= TRIPLET_MASS_MIN*TRIPLET_MASS_MIN && m2 <= TRIPLET_MASS_MAX*TRIPLET_MASS_MAX;
+}
+
+// ------------------------------------------------------------------
+// Get all event inputs, of the 8 TRIPLETS (event_processor.h)
+void event_inputs (const Puppi selected[NPUPPI_SEL], const PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL],
+                   w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features])
+{
+    #pragma HLS inline
+
+    LOOP_EVENT_INPUTS: for (unsigned int i = 0; i < NTRIPLETS; i++)
+    {
+        #pragma HLS unroll
+        gather_triplet_inputs(selected, pairs, TRIPLETS[i][0], TRIPLETS[i][1], TRIPLETS[i][2], BDT_inputs[i]);
+    }
+}
+
+// Same triplets as event_inputs
+void event_kinematics (const Puppi selected[NPUPPI_SEL], const PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL],
+                       mass2_t m2[NTRIPLETS], mass2_t pt2[NTRIPLETS])
+{
+    #pragma HLS inline
+
+    LOOP_EVENT_KINEMATICS: for (unsigned int i = 0; i < NTRIPLETS; i++)
+    {
+        #pragma HLS unroll
+        get_triplet_kinematics(selected, pairs, TRIPLETS[i][0], TRIPLETS[i][1], TRIPLETS[i][2], m2[i], pt2[i]);
+    }
+}
+
+void get_event_inputs (const Puppi selected[NPUPPI_SEL], w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features])
+{
+    #pragma HLS ARRAY_PARTITION variable=selected complete
+    #pragma HLS ARRAY_PARTITION variable=BDT_inputs complete dim=0
+
+    // Pair quantities, shared by the triplets
+    PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL];
+    get_pair_matrix(selected, pairs);
+    event_inputs(selected, pairs, BDT_inputs);
+}
+
+// Squared mass and pT of the triplets of get_event_inputs (for (0,1,0) and (0,1,1), which
+// repeat an index, m2 = 2 m^2(01) and pt2 = |2 pt0 + pt1|^2 and |pt0 + 2 pt1|^2: not triplet quantities)
+void get_event_kinematics (const Puppi selected[NPUPPI_SEL], mass2_t m2[NTRIPLETS], mass2_t pt2[NTRIPLETS])
+{
+    #pragma HLS ARRAY_PARTITION variable=selected complete
+    #pragma HLS ARRAY_PARTITION variable=m2 complete
+    #pragma HLS ARRAY_PARTITION variable=pt2 complete
+
+    PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL];
+    get_pair_matrix(selected, pairs);
+    event_kinematics(selected, pairs, m2, pt2);
 }
 
 // ------------------------------------------------------------------
@@ -702,6 +564,26 @@ void get_event_scores (w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_feature
     }
 }
 
+// BDT scores of the triplets in the mass window, the lowest score for the others
+// (their BDT is not evaluated in C simulation, in firmware its output is not used).
+// Only the distinct triplets (0,1,2), (0,1,3), (0,1,4), (0,2,3), (0,2,4) and (1,2,3) can be
+// in the window: (0,1,0) and (0,1,1) always get the lowest score (distinct_triplet)
+void get_event_scores_veto (w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features], const mass2_t m2[NTRIPLETS],
+                            w3p_bdt::score_t BDT_scores[NTRIPLETS])
+{
+    #pragma HLS ARRAY_PARTITION variable=BDT_inputs complete dim=0
+    #pragma HLS ARRAY_PARTITION variable=m2 complete
+    #pragma HLS ARRAY_PARTITION variable=BDT_scores complete
+
+    LOOP_EVENT_SCORES_VETO: for (unsigned int i = 0; i < NTRIPLETS; i++)
+    {
+        #pragma HLS unroll
+        // lowest score_t value: -2^(iwidth-1)
+        BDT_scores[i] = -(1 << (w3p_bdt::score_t::iwidth-1));
+        if (distinct_triplet(i) && in_mass_window(m2[i])) w3p_bdt::bdt.decision_function(BDT_inputs[i], &BDT_scores[i]);
+    }
+}
+
 // ------------------------------------------------------------------
 // Get highest BDT score
 void get_highest_score (w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::score_t & high_score)
@@ -716,42 +598,10 @@ void get_highest_score (w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::score_t
 }
 
 // ------------------------------------------------------------------
-// Full EventProcessor
-void EventProcessor (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+// Highest BDT score of the triplets of the selected candidates
+void get_max_score (const Puppi selected[NPUPPI_SEL], w3p_bdt::score_t & max_score)
 {
-    #pragma HLS ARRAY_PARTITION variable=input complete
-
-    // Mask candidates
-    ap_uint<NPUPPI_MAX> masked;
-    masker(input, masked);
-
-    // Replace masked candidates with dummy
-    Puppi slimmed[NPUPPI_MAX];
-    slimmer(input, masked, slimmed);
-
-    // Split in arrays and sort them according to pT
-    Puppi ordered1[NSPLITS] , ordered2[NSPLITS] , ordered3[NSPLITS] , ordered4[NSPLITS] ,
-          ordered5[NSPLITS] , ordered6[NSPLITS] , ordered7[NSPLITS] , ordered8[NSPLITS] ,
-          ordered9[NSPLITS] , ordered10[NSPLITS], ordered11[NSPLITS], ordered12[NSPLITS],
-          ordered13[NSPLITS], ordered14[NSPLITS], ordered15[NSPLITS], ordered16[NSPLITS];
-    orderer7(slimmed, 
-             ordered1 , ordered2 , ordered3 , ordered4 ,
-             ordered5 , ordered6 , ordered7 , ordered8 ,
-             ordered9 , ordered10, ordered11, ordered12,
-             ordered13, ordered14, ordered15, ordered16);
-    
-    // Merge the sorted split-arrays
-    Puppi merged[NPUPPI_MAX];
-    merger(ordered1, ordered2, ordered3, ordered4,
-           ordered5, ordered6, ordered7, ordered8,
-           ordered9, ordered10, ordered11, ordered12,
-           ordered13, ordered14, ordered15, ordered16,
-           merged);
-
-    // Select only highest pT ordered-candidates
-    Puppi selected[NPUPPI_SEL];
     #pragma HLS ARRAY_PARTITION variable=selected complete
-    selector(merged, selected);
 
     // Get inputs for each triplet
     w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
@@ -765,53 +615,43 @@ void EventProcessor (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score
     get_highest_score(BDT_scores, max_score);
 }
 
-// EventProcessor7bis - same as event processor, but with 8 arrays
-void EventProcessor7bis (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+// Same as get_max_score for the triplets in the mass window only (lowest score if none)
+void get_max_score_veto (const Puppi selected[NPUPPI_SEL], w3p_bdt::score_t & max_score)
 {
-    #pragma HLS ARRAY_PARTITION variable=input complete
-
-    // Mask candidates
-    ap_uint<NPUPPI_MAX> masked;
-    masker(input, masked);
-
-    // Replace masked candidates with dummy
-    Puppi slimmed[NPUPPI_MAX];
-    slimmer(input, masked, slimmed);
-
-    // Split in arrays and sort them according to pT
-    Puppi ordered1[NSPLITS], ordered2[NSPLITS], ordered3[NSPLITS], ordered4[NSPLITS],
-          ordered5[NSPLITS], ordered6[NSPLITS], ordered7[NSPLITS], ordered8[NSPLITS];
-    orderer7bis(slimmed,
-                ordered1, ordered2, ordered3, ordered4,
-                ordered5, ordered6, ordered7, ordered8);
-    
-    // Merge the sorted split-arrays
-    Puppi merged[NPUPPI_MAX];
-    merger7bis(ordered1, ordered2, ordered3, ordered4,
-               ordered5, ordered6, ordered7, ordered8,
-               merged);
-
-    // Select only highest pT ordered-candidates
-    Puppi selected[NPUPPI_SEL];
     #pragma HLS ARRAY_PARTITION variable=selected complete
-    selector(merged, selected);
 
-    // Get inputs for each triplet
+    // Pair quantities, shared by the BDT inputs and the triplet masses
+    PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL];
+    get_pair_matrix(selected, pairs);
+
     w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
-    get_event_inputs(selected, BDT_inputs);
+    #pragma HLS ARRAY_PARTITION variable=BDT_inputs complete dim=0
+    event_inputs(selected, pairs, BDT_inputs);
+
+    mass2_t m2[NTRIPLETS], pt2[NTRIPLETS];
+    #pragma HLS ARRAY_PARTITION variable=m2 complete
+    #pragma HLS ARRAY_PARTITION variable=pt2 complete
+    event_kinematics(selected, pairs, m2, pt2);
 
-    // Get BDT score for each triplet
     w3p_bdt::score_t BDT_scores[NTRIPLETS];
-    get_event_scores(BDT_inputs, BDT_scores);
+    get_event_scores_veto(BDT_inputs, m2, BDT_scores);
 
-    // Get highest BDT score among triplets
     get_highest_score(BDT_scores, max_score);
 }
 
-// EventProcessor7f - same as EventProcessor7bis, but using orderer7f and merger7f
-void EventProcessor7f (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+// ------------------------------------------------------------------
+// Full EventProcessor, with the candidates sorted in NSUB sub-arrays
+// SORT_KEYS:    sort only the keys (pT + index) and gather the selected candidates
+// SORT_PAYLOAD: sort the whole Puppi candidates
+// SELECT_TOPK:  select the leading keys with the top-K network (NSUB unused)
+// CFG is the merge tree of the sub-arrays (SelectionMergeTree: pruned to NPUPPI_SEL)
+// VETO: only the distinct triplets in the m(3pi) window are scored (get_max_score_veto)
+enum SortMode { SORT_KEYS, SORT_PAYLOAD, SELECT_TOPK };
+
+template<unsigned int NSUB, SortMode MODE, typename CFG = MergeTree<>, bool VETO = false>
+void EventProcessorT (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
 {
-    #pragma HLS ARRAY_PARTITION variable=input complete
+    #pragma HLS inline
 
     // Mask candidates
     ap_uint<NPUPPI_MAX> masked;
@@ -821,28 +661,95 @@ void EventProcessor7f (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_sco
     Puppi slimmed[NPUPPI_MAX];
     slimmer(input, masked, slimmed);
 
-    // Split in arrays and sort them according to pT
-    // Make 2D array of [NSUBARR]x[NSPLITS] = [8]x[26] = 208 for ordering and merging
-    Puppi ordered[NSUBARR][NSPLITS];
-    orderer7f(slimmed, ordered);
-    
-    // Merge the sorted split-arrays
-    Puppi merged[NPUPPI_MAX];
-    merger7f(ordered, merged);
-
-    // Select only highest pT ordered-candidates
+    // Sort according to pT and select only highest pT ordered-candidates
     Puppi selected[NPUPPI_SEL];
     #pragma HLS ARRAY_PARTITION variable=selected complete
-    selector(merged, selected);
+    if (MODE == SORT_KEYS)
+    {
+        sortkey_t sorted[CFG::outputs(NPUPPI_MAX)];
+        sort_keys<NPUPPI_MAX, NSUB, SubArrayNetwork, CFG>(slimmed, sorted);
+        gather<NPUPPI_MAX, NPUPPI_SEL>(slimmed, sorted, selected);
+    }
+    else if (MODE == SELECT_TOPK)
+    {
+        sortkey_t top[NPUPPI_SEL];
+        select_keys<NPUPPI_MAX, NPUPPI_SEL>(slimmed, top);
+        gather<NPUPPI_MAX, NPUPPI_SEL>(slimmed, top, selected);
+    }
+    else
+    {
+        Puppi ordered[NSUB][Geometry<NPUPPI_MAX, NSUB>::nsplit];
+        orderer<NPUPPI_MAX, NSUB>(slimmed, ordered);
+        Puppi merged[CFG::outputs(NPUPPI_MAX)];
+        merger<NPUPPI_MAX, NSUB, Puppi, CFG>(ordered, merged);
+        LOOP_SELECT_MERGED: for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+        {
+            #pragma HLS UNROLL
+            selected[i] = merged[i];
+        }
+    }
 
-    // Get inputs for each triplet
-    w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
-    get_event_inputs(selected, BDT_inputs);
+    // BDT scores of the triplets of the selected candidates
+    if (VETO)
+        get_max_score_veto(selected, max_score);
+    else
+        get_max_score(selected, max_score);
+}
 
-    // Get BDT score for each triplet
-    w3p_bdt::score_t BDT_scores[NTRIPLETS];
-    get_event_scores(BDT_inputs, BDT_scores);
+// EventProcessor - 16 arrays of 13 candidates
+void EventProcessor (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<16, SORT_KEYS>(input, max_score);
+}
 
-    // Get highest BDT score among triplets
-    get_highest_score(BDT_scores, max_score);
+// EventProcessor7bis - 8 arrays of 26 candidates
+void EventProcessor7bis (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<8, SORT_KEYS>(input, max_score);
+}
+
+// EventProcessor4x52 - 4 arrays of 52 candidates
+void EventProcessor4x52 (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<4, SORT_KEYS>(input, max_score);
+}
+
+// EventProcessor7f - NSUBARR arrays of NSPLITS candidates (same sorting as sorter7f + selector7f)
+void EventProcessor7f (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<NSUBARR, SORT_KEYS>(input, max_score);
+}
+
+// EventProcessor7fPayload - same as EventProcessor7f sorting the whole candidates (orderer7f + merger7f)
+void EventProcessor7fPayload (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<NSUBARR, SORT_PAYLOAD>(input, max_score);
+}
+
+// EventProcessor7fPruned - same as EventProcessor7f with the merge tree pruned to the
+// NPUPPI_SEL leading keys (SelectionMergeTree)
+void EventProcessor7fPruned (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<NSUBARR, SORT_KEYS, SelectionMergeTree>(input, max_score);
+}
+
+// EventProcessor7fVeto - same as EventProcessor7f scoring only the distinct triplets with
+// TRIPLET_MASS_MIN <= m(3pi) <= TRIPLET_MASS_MAX
+void EventProcessor7fVeto (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<NSUBARR, SORT_KEYS, MergeTree<>, true>(input, max_score);
+}
+
+// EventProcessorTopK - same as EventProcessor7f with the top-K selection network (topk7f)
+void EventProcessorTopK (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    #pragma HLS ARRAY_PARTITION variable=input complete
+    EventProcessorT<NSUBARR, SELECT_TOPK>(input, max_score);
 }
@@ -2,81 +2,82 @@
 #define EVENT_PROCESSOR_H
 
 #include "data.h"
+#include "pipeline.h"
 #include "../BDT/w3p_bdt.h"
 
+// Index triplets of the selected candidates scored by the firmware (get_event_inputs,
+// get_event_kinematics and all the C++ models of them): 5 from the 1st+2nd pivots, 2 from
+// 1st+3rd and 1 from 2nd+3rd. The first two repeat an index, as the historical loop of
+// get_event_inputs passed its counter as third index; the reference (get_event_inputs_ref)
+// uses (0,1,2)...(0,1,6) instead
+constexpr unsigned char TRIPLETS[NTRIPLETS][3] = {
+    {0, 1, 0}, {0, 1, 1}, {0, 1, 2}, {0, 1, 3}, {0, 1, 4},
+    {0, 2, 3}, {0, 2, 4},
+    {1, 2, 3}
+};
+
+// True if the three indices of TRIPLETS[i] differ. (0,1,0) and (0,1,1) are not triplets: their
+// mass from the pair matrix is 2 m(01) (null diagonal), so the m(3pi) window must not see them
+constexpr bool distinct_triplet (unsigned int i)
+{
+    return TRIPLETS[i][0] != TRIPLETS[i][1] && TRIPLETS[i][0] != TRIPLETS[i][2] && TRIPLETS[i][1] != TRIPLETS[i][2];
+}
+
 // --------------------
 // ----- FIRMWARE -----
 // --------------------
+bool is_masked     (const Puppi & p);
 void masker        (const Puppi input[NPUPPI_MAX], ap_uint<NPUPPI_MAX> & masked);
 void slimmer       (const Puppi input[NPUPPI_MAX], const ap_uint<NPUPPI_MAX> masked, Puppi slimmed[NPUPPI_MAX]);
-void orderer7      (const Puppi slimmed[NPUPPI_MAX],
-                    Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                    Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                    Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                    Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-                    Puppi ordered9 [NSPLITS], Puppi ordered10[NSPLITS],
-                    Puppi ordered11[NSPLITS], Puppi ordered12[NSPLITS],
-                    Puppi ordered13[NSPLITS], Puppi ordered14[NSPLITS],
-                    Puppi ordered15[NSPLITS], Puppi ordered16[NSPLITS]);
-void orderer7bis   (const Puppi slimmed[NPUPPI_MAX],
-                    Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                    Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                    Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                    Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS]);
 void orderer7f     (const Puppi slimmed[NPUPPI_MAX], Puppi ordered[NSUBARR][NSPLITS]);
-void merger        (Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                    Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                    Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                    Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-                    Puppi ordered9 [NSPLITS], Puppi ordered10[NSPLITS],
-                    Puppi ordered11[NSPLITS], Puppi ordered12[NSPLITS],
-                    Puppi ordered13[NSPLITS], Puppi ordered14[NSPLITS],
-                    Puppi ordered15[NSPLITS], Puppi ordered16[NSPLITS],
-                    Puppi merged[NPUPPI_MAX]);
-void merger7bis    (Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                    Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                    Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                    Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-                    Puppi merged[NPUPPI_MAX]);
 void merger7f      (Puppi ordered[NSUBARR][NSPLITS], Puppi merged[NPUPPI_MAX]);
+void merger7f_pruned(const Puppi slimmed[NPUPPI_MAX], Puppi merged[NPUPPI_SEL]);
+void sorter7f      (const Puppi slimmed[NPUPPI_MAX], sortkey_t sorted[NPUPPI_MAX]);
 void selector      (const Puppi merged[NPUPPI_MAX], Puppi selected[NPUPPI_SEL]);
+void selector7f    (const Puppi slimmed[NPUPPI_MAX], const sortkey_t sorted[NPUPPI_MAX], Puppi selected[NPUPPI_SEL]);
+void topk7f        (const Puppi slimmed[NPUPPI_MAX], Puppi selected[NPUPPI_SEL]);
 void get_triplet_inputs(const Puppi selected[NPUPPI_SEL], idx_t idx0, idx_t idx1, idx_t idx2, w3p_bdt::input_t BDT_inputs[w3p_bdt::n_features]);
+void get_pair_matrix       (const Puppi selected[NPUPPI_SEL], PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL]);
+void gather_triplet_inputs(const Puppi selected[NPUPPI_SEL], const PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL], idx_t idx0, idx_t idx1, idx_t idx2, w3p_bdt::input_t BDT_inputs[w3p_bdt::n_features]);
+void _lut_cos_init     (cos_t table_cos[COSCOSH_LUT_SIZE]);
+void _lut_cosh_init    (cosh_t table_cosh[COSCOSH_LUT_SIZE]);
+void _lut_coshw_init   (coshw_t table_coshw[COSCOSH_LUT_SIZE]);
 cos_t get_cos_phi      (Puppi::phi_t phi);
 cosh_t get_cosh_eta    (Puppi::eta_t eta);
+coshw_t get_coshw_eta  (Puppi::eta_t eta);
 mass_t get_pair_mass   (const Puppi & p1, const Puppi & p2);
 void get_event_inputs  (const Puppi selected[NPUPPI_SEL], w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features]);
+void get_event_kinematics(const Puppi selected[NPUPPI_SEL], mass2_t m2[NTRIPLETS], mass2_t pt2[NTRIPLETS]);
 void get_event_scores  (w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features], w3p_bdt::score_t BDT_scores[NTRIPLETS]);
+void get_event_scores_veto(w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features], const mass2_t m2[NTRIPLETS], w3p_bdt::score_t BDT_scores[NTRIPLETS]);
 void get_highest_score (w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::score_t & high_score);
+void get_max_score     (const Puppi selected[NPUPPI_SEL], w3p_bdt::score_t & max_score);
+void get_max_score_veto(const Puppi selected[NPUPPI_SEL], w3p_bdt::score_t & max_score);
 void EventProcessor    (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
 void EventProcessor7bis(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
+void EventProcessor4x52(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
 void EventProcessor7f  (const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
+void EventProcessor7fPayload(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
+void EventProcessor7fPruned(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
+void EventProcessor7fVeto(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
+void EventProcessorTopK(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
 
 // ---------------------
 // ----- REFERENCE -----
 // ---------------------
 void masker_ref        (const Puppi input[NPUPPI_MAX], ap_uint<NPUPPI_MAX> & masked);
 void slimmer_ref       (const Puppi input[NPUPPI_MAX], const ap_uint<NPUPPI_MAX> masked, Puppi slimmed[NPUPPI_MAX]);
-void orderer7_ref      (const Puppi slimmed[NPUPPI_MAX],
-                        Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                        Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                        Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                        Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS],
-                        Puppi ordered9 [NSPLITS], Puppi ordered10[NSPLITS],
-                        Puppi ordered11[NSPLITS], Puppi ordered12[NSPLITS],
-                        Puppi ordered13[NSPLITS], Puppi ordered14[NSPLITS],
-                        Puppi ordered15[NSPLITS], Puppi ordered16[NSPLITS]);
-void orderer7bis_ref   (const Puppi slimmed[NPUPPI_MAX],
-                        Puppi ordered1 [NSPLITS], Puppi ordered2 [NSPLITS],
-                        Puppi ordered3 [NSPLITS], Puppi ordered4 [NSPLITS],
-                        Puppi ordered5 [NSPLITS], Puppi ordered6 [NSPLITS],
-                        Puppi ordered7 [NSPLITS], Puppi ordered8 [NSPLITS]);
+void orderer_ref       (const Puppi slimmed[NPUPPI_MAX], unsigned int nsplit, Puppi ordered[NPUPPI_MAX]);
 void merger_ref        (Puppi slimmed[NPUPPI_MAX], Puppi merged[NPUPPI_MAX]);
 void selector_ref      (const Puppi merged[NPUPPI_MAX], Puppi selected[NPUPPI_SEL]);
 mass_t get_pair_mass_ref   (const Puppi & p1, const Puppi & p2);
 void get_triplet_inputs_ref(const Puppi selected[NPUPPI_SEL], idx_t idx0, idx_t idx1, idx_t idx2, w3p_bdt::input_t BDT_inputs[w3p_bdt::n_features]);
+void get_triplet_kinematics_ref(const Puppi selected[NPUPPI_SEL], idx_t idx0, idx_t idx1, idx_t idx2, double & mass, double & pt);
 void get_event_inputs_ref  (const Puppi selected[NPUPPI_SEL], w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features]);
+void get_event_window_ref  (const Puppi selected[NPUPPI_SEL], double mass[NTRIPLETS], bool in_window[NTRIPLETS]);
 void get_event_scores_ref  (w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features], w3p_bdt::score_t BDT_scores[NTRIPLETS]);
 void get_highest_score_ref (w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::score_t & high_score);
 void EventProcessor_ref(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
+void EventProcessorVeto_ref(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score);
 
 #endif
@@ -0,0 +1,359 @@
+#ifndef NATIVE_TYPES_H
+#define NATIVE_TYPES_H
+
+#include "ap_int.h"
+#include "ap_fixed.h"
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+// ------------------------------------------------------------------
+// Native-integer emulation of the ap_* types, for fast C simulation only
+//
+// native::ap_int/ap_uint/ap_fixed/ap_ufixed hold the raw value in an int16/int32/int64
+// and follow the ap_* rules bit by bit:
+//  - the result of + - * has the full-precision ap_* result type (width, integer bits, sign),
+//    so that e.g. an `auto` difference wraps exactly as the ap_* one on compound assignment
+//  - assignment to a narrower type quantizes (AP_TRN, AP_TRN_ZERO, AP_RND, AP_RND_ZERO,
+//    AP_RND_MIN_INF, AP_RND_INF, AP_RND_CONV) and then handles overflow (AP_WRAP, AP_SAT,
+//    AP_SAT_ZERO, AP_SAT_SYM); integer types convert from double/fixed towards zero as ap_int
+//  - relational operators compare exact values, comparisons with float/double go through to_double()
+// Intermediate results are computed in int64: this is exact as long as the values (not the
+// nominal ap_* result widths, which can be larger) fit in 64 bits, as for all the expressions
+// of the firmware. Types are limited to 64 bits (ap_uint<NPUPPI_MAX> stays an ap_uint).
+//
+// The arithmetic types of data.h and w3p_bdt.h are declared through the `arith` namespace:
+// ap_* by default, native::* when compiling with -DW3P_NATIVE_TYPES (bit-exact, see
+// tools/check_native_types.cc). Never for synthesis.
+namespace native {
+
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O>
+    class fixed_base;
+
+    // Integer types are fixed_base<W, W, S> with AP_TRN_ZERO: same conversions as ap_int
+    template<int W> using ap_int  = fixed_base<W, W, true,  AP_TRN_ZERO, AP_WRAP>;
+    template<int W> using ap_uint = fixed_base<W, W, false, AP_TRN_ZERO, AP_WRAP>;
+    template<int W, int I, ap_q_mode Q = AP_TRN, ap_o_mode O = AP_WRAP>
+    using ap_fixed  = fixed_base<W, I, true, Q, O>;
+    template<int W, int I, ap_q_mode Q = AP_TRN, ap_o_mode O = AP_WRAP>
+    using ap_ufixed = fixed_base<W, I, false, Q, O>;
+
+    namespace detail {
+
+        constexpr int max(int a, int b) { return a > b ? a : b; }
+
+        // Smallest native integer holding a W-bit value
+        template<int W, bool S>
+        struct storage {
+            typedef typename std::conditional<(W + !S <= 16), int16_t,
+                    typename std::conditional<(W + !S <= 32), int32_t, int64_t>::type>::type type;
+        };
+
+        // r * 2^N for N >= 0, r / 2^-N (floor) for N < 0
+        template<int N>
+        inline int64_t shift(int64_t r)
+        {
+            return N >= 0 ? int64_t(uint64_t(r) << (N >= 0 ? N : 0)) : r >> (N < 0 ? -N : 0);
+        }
+
+        // Rounding carry of quantization mode Q, given the sign, the parity of the truncated
+        // value and how the dropped part compares to half an LSB (-1, 0, +1)
+        template<ap_q_mode Q>
+        inline bool carry(bool neg, bool odd, int half, bool inexact)
+        {
+            switch (Q)
+            {
+                case AP_TRN_ZERO:    return neg && inexact;
+                case AP_RND:         return half >= 0;
+                case AP_RND_ZERO:    return half > 0 || (half == 0 && neg);
+                case AP_RND_MIN_INF: return half > 0;
+                case AP_RND_INF:     return half > 0 || (half == 0 && !neg);
+                case AP_RND_CONV:    return half > 0 || (half == 0 && odd);
+                default:             return false; // AP_TRN
+            }
+        }
+
+        // ap_* type of a C integer operand
+        template<typename T>
+        struct c_type {
+            typedef fixed_base<std::is_same<T, bool>::value ? 1 : int(8 * sizeof(T)),
+                               std::is_same<T, bool>::value ? 1 : int(8 * sizeof(T)),
+                               std::is_signed<T>::value, AP_TRN_ZERO, AP_WRAP> type;
+        };
+
+        template<typename T>
+        using enable_if_int = typename std::enable_if<std::is_integral<T>::value, int>::type;
+
+        template<typename T>
+        using enable_if_float = typename std::enable_if<std::is_floating_point<T>::value, int>::type;
+
+        // Result type of W bits of which F fractional, capped at 64 bits (values fit in int64 anyway)
+        template<int W, int F, bool S, ap_q_mode Q>
+        using result = fixed_base<(W < 64 ? W : 64), (W < 64 ? W : 64) - F, S, Q, AP_WRAP>;
+
+        // Full-precision result types, as ap_fixed_base::RType
+        template<int W1, int I1, bool S1, ap_q_mode Q1, int W2, int I2, bool S2, ap_q_mode Q2>
+        struct rtype {
+            static constexpr int F1 = W1 - I1, F2 = W2 - I2, F = max(F1, F2);
+            static constexpr int plus_i = max(I1 + (S2 && !S1), I2 + (S1 && !S2)) + 1;
+            static constexpr ap_q_mode q = (Q1 == AP_TRN_ZERO && Q2 == AP_TRN_ZERO) ? AP_TRN_ZERO : AP_TRN;
+            typedef result<plus_i + F, F, S1 || S2, q> plus;
+            typedef result<plus_i + F, F, true,     q> minus;
+            typedef result<W1 + W2, F1 + F2, S1 || S2, q> mult;
+        };
+
+    } // namespace detail
+
+    // Range of bits hi..lo of a native value, as ap_range_ref
+    template<typename T>
+    class range_ref {
+        public:
+            range_ref(T & v, int hi, int lo) : v_(v), hi_(hi), lo_(lo) {}
+            operator unsigned long long() const { return get(); }
+            unsigned long long to_uint64() const { return get(); }
+            int to_int() const { return int(get()); }
+            range_ref & operator= (unsigned long long bits) { v_.set_range(hi_, lo_, bits); return *this; }
+            range_ref & operator= (const range_ref & r) { return *this = (unsigned long long)r; }
+            template<typename R, detail::enable_if_int<R> = 0> range_ref & operator= (R bits) { return *this = (unsigned long long)bits; }
+            template<typename R, typename std::enable_if<!std::is_integral<R>::value, int>::type = 0>
+            range_ref & operator= (const R & r) { return *this = ::ap_uint<64>(r).to_uint64(); }
+        private:
+            T & v_;
+            int hi_, lo_;
+            unsigned long long get() const { return static_cast<const T &>(v_).range(hi_, lo_); }
+    };
+
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O>
+    class fixed_base {
+        static_assert(W > 0 && W <= 64, "native types hold at most 64 bits");
+        static_assert(O != AP_WRAP_SM, "AP_WRAP_SM is not emulated");
+
+        public:
+            static constexpr int width  = W;
+            static constexpr int iwidth = I;
+            static constexpr int F = W - I;
+            static constexpr bool sign_flag = S;
+            static constexpr bool is_integer = (Q == AP_TRN_ZERO && I == W);
+            typedef typename detail::storage<W, S>::type raw_t;
+            typedef typename std::conditional<is_integer, long long, double>::type native_t;
+
+            fixed_base() : V(0) {}
+            template<typename T, detail::enable_if_int<T> = 0>
+            fixed_base(T v) { from_raw<0>(int64_t(v)); }
+            template<typename T, detail::enable_if_float<T> = 0>
+            fixed_base(T v) { from_double(v); }
+            template<int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2>
+            fixed_base(const fixed_base<W2, I2, S2, Q2, O2> & v) { from_raw<W2 - I2>(v.raw()); }
+            template<int W2, bool S2>
+            fixed_base(const ::ap_int_base<W2, S2> & v) { static_assert(W2 <= 64, "ap_int wider than 64 bits"); from_raw<0>(int64_t(v.to_int64())); }
+
+            // raw value: the ap_* bits, sign extended for signed types
+            int64_t raw() const { return V; }
+            static fixed_base from_bits(int64_t r) { fixed_base v; v.V = wrap(r); return v; }
+
+            // conversions
+            long long to_int64() const { return detail::shift<-F>(V < 0 && F > 0 ? V + ((int64_t(1) << (F > 0 ? F : 0)) - 1) : V); }
+            int to_int() const { return int(to_int64()); }
+            unsigned to_uint() const { return unsigned(to_int64()); }
+            long to_long() const { return long(to_int64()); }
+            unsigned long long to_uint64() const { return (unsigned long long)to_int64(); }
+            double to_double() const { return std::ldexp(double(V), -F); }
+            float to_float() const { return float(to_double()); }
+            operator native_t() const { return is_integer ? native_t(V) : native_t(to_double()); }
+            std::string to_string() const { return is_integer ? std::to_string(to_int64()) : std::to_string(to_double()); }
+
+            // bits
+            unsigned long long range(int hi, int lo) const
+            {
+                unsigned long long bits = (unsigned long long)(V) >> lo;
+                return hi - lo >= 63 ? bits : bits & ((1ULL << (hi - lo + 1)) - 1);
+            }
+            unsigned long long operator() (int hi, int lo) const { return range(hi, lo); }
+            range_ref<fixed_base> range(int hi, int lo) { return range_ref<fixed_base>(*this, hi, lo); }
+            range_ref<fixed_base> operator() (int hi, int lo) { return range_ref<fixed_base>(*this, hi, lo); }
+            bool operator[] (int i) const { return (uint64_t(V) >> i) & 1; }
+            void set_range(int hi, int lo, unsigned long long bits)
+            {
+                uint64_t mask = (hi - lo >= 63 ? ~0ULL : (1ULL << (hi - lo + 1)) - 1) << lo;
+                V = wrap(int64_t((uint64_t(V) & ~mask) | ((bits << lo) & mask)));
+            }
+            fixed_base operator~ () const { return from_bits(~int64_t(V)); }
+
+            // compound assignments: full-precision operation, then quantization/overflow of this type
+            template<typename T> fixed_base & operator+= (const T & v) { return *this = *this + v; }
+            template<typename T> fixed_base & operator-= (const T & v) { return *this = *this - v; }
+            template<typename T> fixed_base & operator*= (const T & v) { return *this = *this * v; }
+            fixed_base & operator++ () { return *this += 1; }
+            fixed_base & operator-- () { return *this -= 1; }
+            fixed_base operator++ (int) { fixed_base t = *this; ++*this; return t; }
+            fixed_base operator-- (int) { fixed_base t = *this; --*this; return t; }
+
+            typedef detail::result<W + 1, F, true, (Q == AP_TRN_ZERO ? AP_TRN_ZERO : AP_TRN)> neg_t;
+            neg_t operator- () const { return neg_t::from_bits(-int64_t(V)); }
+            fixed_base operator+ () const { return *this; }
+
+        private:
+            raw_t V;
+
+            static constexpr int64_t max_raw() { return W >= 64 ? INT64_MAX : (S ? (int64_t(1) << (W - 1)) - 1 : (int64_t(1) << W) - 1); }
+            static constexpr int64_t min_raw() { return W >= 64 ? INT64_MIN : (S ? -(int64_t(1) << (W - 1)) : 0); }
+
+            // Keep the low W bits (sign extended for signed types)
+            static int64_t wrap(int64_t r)
+            {
+                if (W >= 64) return r;
+                const int n = W >= 64 ? 0 : 64 - W;
+                return S ? int64_t(uint64_t(r) << n) >> n : int64_t(uint64_t(r) << n >> n);
+            }
+
+            // Overflow handling of a quantized raw value
+            static int64_t overflow(int64_t r)
+            {
+                if (r >= min_raw() && r <= max_raw()) return r;
+                switch (O)
+                {
+                    case AP_SAT:      return r > max_raw() ? max_raw() : min_raw();
+                    case AP_SAT_ZERO: return 0;
+                    case AP_SAT_SYM:  return r > max_raw() ? max_raw() : (S ? -max_raw() : 0);
+                    default:          return wrap(r);
+                }
+            }
+
+            // Assign a raw value with F2 fractional bits
+            template<int F2>
+            void from_raw(int64_t r)
+            {
+                if (F2 > F)
+                {
+                    constexpr int D = F2 > F ? F2 - F : 1;
+                    const int64_t half = int64_t(1) << (D - 1);
+                    const int64_t rem = r & ((half << 1) - 1);
+                    int64_t q = r >> D;
+                    q += detail::carry<Q>(r < 0, q & 1, rem < half ? -1 : (rem > half ? 1 : 0), rem != 0);
+                    V = raw_t(overflow(q));
+                }
+                else V = raw_t(overflow(detail::shift<F - F2>(r)));
+            }
+
+            // Assign a double (exact value, then same quantization and overflow)
+            void from_double(double v)
+            {
+                const double s = std::ldexp(v, F);
+                const double fl = std::floor(s);
+                const double rem = s - fl;
+                double q = fl + detail::carry<Q>(s < 0, std::fmod(fl, 2.) != 0, rem < 0.5 ? -1 : (rem > 0.5 ? 1 : 0), rem != 0);
+                if (q >= 0x1p62 || q <= -0x1p62) // out of any 63-bit range
+                {
+                    if (O == AP_WRAP)
+                    {
+                        q = std::fmod(q, 0x1p64);
+                        if (q >= 0x1p63) q -= 0x1p64;
+                        else if (q < -0x1p63) q += 0x1p64;
+                    }
+                    else { V = raw_t(overflow(q > 0 ? INT64_MAX : INT64_MIN)); return; }
+                }
+                V = raw_t(overflow(int64_t(q)));
+            }
+
+            template<int, int, bool, ap_q_mode, ap_o_mode> friend class fixed_base;
+    };
+
+    // ------------------------------------------------------------------
+    // Binary operators, with the ap_* full-precision result types
+
+#define NATIVE_FIXED_T(n) fixed_base<W##n, I##n, S##n, Q##n, O##n>
+#define NATIVE_FIXED_TPL  template<int W1, int I1, bool S1, ap_q_mode Q1, ap_o_mode O1, int W2, int I2, bool S2, ap_q_mode Q2, ap_o_mode O2>
+#define NATIVE_RTYPE(op)  typename detail::rtype<W1, I1, S1, Q1, W2, I2, S2, Q2>::op
+
+    NATIVE_FIXED_TPL
+    inline NATIVE_RTYPE(plus) operator+ (const NATIVE_FIXED_T(1) & a, const NATIVE_FIXED_T(2) & b)
+    {
+        typedef NATIVE_RTYPE(plus) R;
+        return R::from_bits(detail::shift<R::F - (W1 - I1)>(a.raw()) + detail::shift<R::F - (W2 - I2)>(b.raw()));
+    }
+
+    NATIVE_FIXED_TPL
+    inline NATIVE_RTYPE(minus) operator- (const NATIVE_FIXED_T(1) & a, const NATIVE_FIXED_T(2) & b)
+    {
+        typedef NATIVE_RTYPE(minus) R;
+        return R::from_bits(detail::shift<R::F - (W1 - I1)>(a.raw()) - detail::shift<R::F - (W2 - I2)>(b.raw()));
+    }
+
+    NATIVE_FIXED_TPL
+    inline NATIVE_RTYPE(mult) operator* (const NATIVE_FIXED_T(1) & a, const NATIVE_FIXED_T(2) & b)
+    {
+        typedef NATIVE_RTYPE(mult) R;
+        return R::from_bits(a.raw() * b.raw());
+    }
+
+    // Exact comparisons, on the common number of fractional bits
+#define NATIVE_REL_OP(op) \
+    NATIVE_FIXED_TPL \
+    inline bool operator op (const NATIVE_FIXED_T(1) & a, const NATIVE_FIXED_T(2) & b) \
+    { \
+        constexpr int F = detail::max(W1 - I1, W2 - I2); \
+        return detail::shift<F - (W1 - I1)>(a.raw()) op detail::shift<F - (W2 - I2)>(b.raw()); \
+    }
+    NATIVE_REL_OP(==)
+    NATIVE_REL_OP(!=)
+    NATIVE_REL_OP(<)
+    NATIVE_REL_OP(<=)
+    NATIVE_REL_OP(>)
+    NATIVE_REL_OP(>=)
+#undef NATIVE_REL_OP
+
+    // C integers take part as ap_int<8*sizeof>, floating point values via to_double()
+#define NATIVE_MIXED_OP(op) \
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O, typename T, detail::enable_if_int<T> = 0> \
+    inline auto operator op (const fixed_base<W, I, S, Q, O> & a, T b) -> decltype(a op typename detail::c_type<T>::type(b)) \
+    { return a op typename detail::c_type<T>::type(b); } \
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O, typename T, detail::enable_if_int<T> = 0> \
+    inline auto operator op (T a, const fixed_base<W, I, S, Q, O> & b) -> decltype(typename detail::c_type<T>::type(a) op b) \
+    { return typename detail::c_type<T>::type(a) op b; } \
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O, typename T, detail::enable_if_float<T> = 0> \
+    inline auto operator op (const fixed_base<W, I, S, Q, O> & a, T b) -> decltype(a.to_double() op b) \
+    { return a.to_double() op b; } \
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O, typename T, detail::enable_if_float<T> = 0> \
+    inline auto operator op (T a, const fixed_base<W, I, S, Q, O> & b) -> decltype(a op b.to_double()) \
+    { return a op b.to_double(); }
+    NATIVE_MIXED_OP(+)
+    NATIVE_MIXED_OP(-)
+    NATIVE_MIXED_OP(*)
+    NATIVE_MIXED_OP(==)
+    NATIVE_MIXED_OP(!=)
+    NATIVE_MIXED_OP(<)
+    NATIVE_MIXED_OP(<=)
+    NATIVE_MIXED_OP(>)
+    NATIVE_MIXED_OP(>=)
+#undef NATIVE_MIXED_OP
+
+#undef NATIVE_RTYPE
+#undef NATIVE_FIXED_TPL
+#undef NATIVE_FIXED_T
+
+    template<int W, int I, bool S, ap_q_mode Q, ap_o_mode O>
+    inline std::ostream & operator<< (std::ostream & os, const fixed_base<W, I, S, Q, O> & v)
+    {
+        if (fixed_base<W, I, S, Q, O>::is_integer) return os << v.to_int64();
+        return os << v.to_double();
+    }
+
+} // namespace native
+
+#ifdef W3P_NATIVE_TYPES
+#ifdef __SYNTHESIS__
+#error "W3P_NATIVE_TYPES is for C simulation only"
+#endif
+namespace arith = native;
+#else
+namespace arith {
+    using ::ap_int;
+    using ::ap_uint;
+    using ::ap_fixed;
+    using ::ap_ufixed;
+}
+#endif
+
+#endif
@@ -0,0 +1,487 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include "data.h"
+#include "bitonic_hybrid.h"
+
+// ------------------------------------------------------------------
+// Sorting pipeline geometry: NIN candidates split in NSUB sub-arrays of
+// NIN/NSUB candidates, each one sorted by pT, then merged back in pairs by a
+// tree of log2(NSUB) levels of bitonic mergers.
+// Everything below is generated at compile time from (NIN, NSUB), e.g.
+//   orderer<NPUPPI_MAX, 16>  +  merger<NPUPPI_MAX, 16>  -> 16 x 13
+//   orderer<NPUPPI_MAX,  8>  +  merger<NPUPPI_MAX,  8>  ->  8 x 26
+//   orderer<NPUPPI_MAX,  4>  +  merger<NPUPPI_MAX,  4>  ->  4 x 52
+// T is the sorted type: anything with operator< (Puppi by default).
+template<unsigned int NIN, unsigned int NSUB>
+struct Geometry {
+    static_assert(NSUB > 0 && (NSUB & (NSUB - 1)) == 0, "number of sub-arrays must be a power of 2");
+    static_assert(NIN % NSUB == 0, "sub-arrays must all have the same size");
+    static constexpr unsigned int nin    = NIN;
+    static constexpr unsigned int nsub   = NSUB;
+    static constexpr unsigned int nsplit = NIN / NSUB;
+};
+
+// Network family of the sub-array sorters (hybridBitonicSort::Bitonic, OddEvenMerge or Pairwise),
+// see hybridBitonicSort::sorterComparators/sorterDepth: for 13/26/52 candidates the hybrid
+// Bitonic is the shallowest (depth 9/14/20, 47/144/428 comparators), OddEvenMerge and Pairwise
+// have 48/146/417 comparators at depth 10/15/21. With sort keys all of them give the
+// same order; on whole candidates equal-pT ones may come out in a different order.
+typedef hybridBitonicSort::Bitonic SubArrayNetwork;
+
+// ------------------------------------------------------------------
+// Orderer: split in NSUB arrays and sort each of them
+template<unsigned int NIN, unsigned int NSUB, typename T = Puppi, typename NET = SubArrayNetwork>
+void orderer (const T slimmed[NIN], T ordered[NSUB][Geometry<NIN, NSUB>::nsplit])
+{
+    #pragma HLS ARRAY_PARTITION variable=slimmed complete
+    #pragma HLS ARRAY_PARTITION variable=ordered complete dim=2
+    static constexpr unsigned int NSPLIT = Geometry<NIN, NSUB>::nsplit;
+
+    LOOP_ORDERER_SPLIT: for (unsigned int k = 0; k < NSUB; k++)
+    {
+        #pragma HLS UNROLL
+        for (unsigned int i = 0; i < NSPLIT; i++)
+        {
+            #pragma HLS UNROLL
+            ordered[k][i] = slimmed[i + k*NSPLIT];
+        }
+    }
+
+    LOOP_ORDERER_SORT: for (unsigned int k = 0; k < NSUB; k++)
+    {
+        #pragma HLS UNROLL
+        hybridBitonicSort::bitonicSorter<T, NSPLIT, 0, true, NET>::run(ordered[k], 0);
+    }
+}
+
+// ------------------------------------------------------------------
+// Utils for merge-sorting
+
+// Concatenate two descending arrays of N elements into a bitonic sequence
+template<unsigned int N, typename T>
+void get_bitonic_sequence (const T in1[N], const T in2[N], T bitonic[2*N])
+{
+    #pragma HLS array_partition variable=in1 complete
+    #pragma HLS array_partition variable=in2 complete
+    #pragma HLS array_partition variable=bitonic complete
+    make_bitonic_loop: for (int id = 0, ia = N-1; id < int(N); id++, ia--)
+    {
+        #pragma HLS UNROLL
+        bitonic[id] = in1[ia];
+        bitonic[id+N] = in2[id];
+    }
+}
+
+// Merge two descending arrays of N elements
+template<unsigned int N, typename T>
+void merge_sort (const T in1[N], const T in2[N], T sorted_out[2*N])
+{
+    #pragma HLS array_partition variable=in1 complete
+    #pragma HLS array_partition variable=in2 complete
+    #pragma HLS array_partition variable=sorted_out complete
+    get_bitonic_sequence<N, T>(in1, in2, sorted_out);
+    hybridBitonicSort::bitonicMerger<T, 2*N, 0>::run(sorted_out, 0);
+}
+
+// Sorted K largest of two descending arrays of at least K elements:
+// max(in1[i], in2[K-1-i]) holds the K largest of the two and is a V-shaped sequence
+// (K comparators), which an ascending bitonic merger of K sorts (any K), read backwards
+template<unsigned int K, typename T>
+void topk_merge (const T in1[K], const T in2[K], T out[K])
+{
+    #pragma HLS array_partition variable=in1 complete
+    #pragma HLS array_partition variable=in2 complete
+    #pragma HLS array_partition variable=out complete
+    T top[K];
+    #pragma HLS array_partition variable=top complete
+    LOOP_TOPK_MAX: for (unsigned int i = 0; i < K; i++)
+    {
+        #pragma HLS UNROLL
+        top[i] = (in1[i] < in2[K-1-i]) ? in2[K-1-i] : in1[i];
+    }
+    hybridBitonicSort::bitonicMerger<T, K, 1>::run(top, 0);
+    LOOP_TOPK_OUT: for (unsigned int i = 0; i < K; i++)
+    {
+        #pragma HLS UNROLL
+        out[i] = top[K-1-i];
+    }
+}
+
+// Outputs kept by a merge of n elements truncated to nout (0: no truncation)
+static constexpr unsigned int truncated_size (unsigned int n, unsigned int nout)
+{
+    return (nout && nout < n) ? nout : n;
+}
+
+// Merge two descending arrays of N elements, keeping the first NOUT outputs (0: all of them)
+template<unsigned int N, unsigned int NOUT, typename T,
+         int MODE = (truncated_size(2*N, NOUT) == 2*N) ? 0 : (NOUT <= N ? 1 : 2)>
+struct truncatedMerge {
+    // all the outputs
+    static void run(const T in1[N], const T in2[N], T out[2*N])
+    {
+        #pragma HLS inline
+        merge_sort<N, T>(in1, in2, out);
+    }
+};
+
+template<unsigned int N, unsigned int NOUT, typename T>
+struct truncatedMerge<N, NOUT, T, 1> {
+    // only the first NOUT of each array can survive
+    static void run(const T in1[N], const T in2[N], T out[NOUT])
+    {
+        #pragma HLS inline
+        topk_merge<NOUT, T>(in1, in2, out);
+    }
+};
+
+template<unsigned int N, unsigned int NOUT, typename T>
+struct truncatedMerge<N, NOUT, T, 2> {
+    // N < NOUT < 2N: whole merge, the last outputs are dropped
+    static void run(const T in1[N], const T in2[N], T out[NOUT])
+    {
+        #pragma HLS inline
+        T merged[2*N];
+        #pragma HLS array_partition variable=merged complete
+        merge_sort<N, T>(in1, in2, merged);
+        for (unsigned int i = 0; i < NOUT; i++)
+        {
+            #pragma HLS UNROLL
+            out[i] = merged[i];
+        }
+    }
+};
+
+// ------------------------------------------------------------------
+// Merge tree: FANIN sorted arrays are merged by each node, level after level, until
+// one is left. Inside a node they are merged pairwise ((0,1) (2,3) ... then (01,23) ...),
+// so the comparators do not depend on FANIN, only the function boundaries do. Every merge
+// keeps only the first NOUT outputs (NOUT = 0: all of them), POLICY says how the nodes
+// of each level are implemented.
+//
+// merger7f (8 x 26) with MergeTree<2, 0, MergePolicy<INLINE_OFF, SHARED>> over the levels
+// merge_sort<26>/<52>/<104> (bits 0/1/2) covers the resource experiments v0-v11.
+
+// Implementation of the nodes of each level (level 0 merges the sub-arrays):
+// bit l of INLINE_OFF -> the level-l nodes are not inlined, one instance each
+// bit l of SHARED     -> not inlined and limited to one instance (ALLOCATION limit=1)
+template<unsigned int INLINE_OFF = 0, unsigned int SHARED = 0>
+struct MergePolicy {
+    static constexpr bool inlined(unsigned int level) { return !(((INLINE_OFF | SHARED) >> level) & 1); }
+    static constexpr bool shared (unsigned int level) { return (SHARED >> level) & 1; }
+};
+
+template<unsigned int FANIN = 2, unsigned int NOUT = 0, typename POLICY = MergePolicy<>>
+struct MergeTree {
+    static_assert(FANIN >= 2 && (FANIN & (FANIN-1)) == 0, "merge tree fan-in must be a power of 2");
+    static constexpr unsigned int fanin = FANIN;
+    static constexpr unsigned int nout  = NOUT;
+    typedef POLICY policy;
+    static constexpr unsigned int outputs(unsigned int nin) { return truncated_size(nin, NOUT); }
+};
+
+// One level of the tree over NARR sorted arrays of N elements, then the next ones
+template<typename T, unsigned int NARR, unsigned int N, typename CFG, unsigned int LEVEL = 0>
+struct mergeLevels {
+    static constexpr unsigned int fanin  = CFG::fanin < NARR ? CFG::fanin : NARR;
+    static constexpr unsigned int nnodes = NARR / fanin;
+    static constexpr unsigned int size   = mergeLevels<T, fanin, N, MergeTree<2, CFG::nout>>::output;
+    static constexpr unsigned int output = mergeLevels<T, nnodes, size, CFG, LEVEL+1>::output;
+    static_assert(NARR % fanin == 0, "number of sorted arrays must be a multiple of the merge tree fan-in");
+
+    static void run(const T in[NARR][N], T merged[output]);
+};
+
+template<typename T, unsigned int N, typename CFG, unsigned int LEVEL>
+struct mergeLevels<T, 1, N, CFG, LEVEL> {
+    static constexpr unsigned int output = N;
+
+    static void run(const T in[1][N], T merged[N])
+    {
+        #pragma HLS inline
+        for (unsigned int i = 0; i < N; i++)
+        {
+            #pragma HLS UNROLL
+            merged[i] = in[0][i];
+        }
+    }
+};
+
+template<typename T, unsigned int N, unsigned int NOUT, unsigned int LEVEL>
+struct mergeLevels<T, 2, N, MergeTree<2, NOUT>, LEVEL> {
+    static constexpr unsigned int output = truncated_size(2*N, NOUT);
+
+    static void run(const T in[2][N], T merged[output])
+    {
+        #pragma HLS inline
+        truncatedMerge<N, NOUT, T>::run(in[0], in[1], merged);
+    }
+};
+
+// Node merging FANIN sorted arrays of N elements, inlined or not
+template<typename T, unsigned int FANIN, unsigned int N, unsigned int NOUT>
+void merge_node_inline (const T in[FANIN][N], T out[mergeLevels<T, FANIN, N, MergeTree<2, NOUT>>::output])
+{
+    #pragma HLS inline
+    mergeLevels<T, FANIN, N, MergeTree<2, NOUT>>::run(in, out);
+}
+
+template<typename T, unsigned int FANIN, unsigned int N, unsigned int NOUT>
+void merge_node (const T in[FANIN][N], T out[mergeLevels<T, FANIN, N, MergeTree<2, NOUT>>::output])
+{
+    #pragma HLS inline off
+    #pragma HLS array_partition variable=in complete dim=0
+    #pragma HLS array_partition variable=out complete
+    mergeLevels<T, FANIN, N, MergeTree<2, NOUT>>::run(in, out);
+}
+
+template<typename T, unsigned int FANIN, unsigned int N, unsigned int NOUT>
+void merge_node_shared (const T in[FANIN][N], T out[mergeLevels<T, FANIN, N, MergeTree<2, NOUT>>::output])
+{
+    #pragma HLS inline off
+    #pragma HLS array_partition variable=in complete dim=0
+    #pragma HLS array_partition variable=out complete
+    mergeLevels<T, FANIN, N, MergeTree<2, NOUT>>::run(in, out);
+}
+
+template<typename T, unsigned int NARR, unsigned int N, typename CFG, unsigned int LEVEL>
+void mergeLevels<T, NARR, N, CFG, LEVEL>::run(const T in[NARR][N], T merged[output])
+{
+    #pragma HLS inline
+    #pragma HLS ALLOCATION function instances=merge_node_shared limit=1
+    T out[nnodes][size];
+    #pragma HLS ARRAY_PARTITION variable=out complete dim=0
+    LOOP_MERGE_NODES: for (unsigned int g = 0; g < nnodes; g++)
+    {
+        #pragma HLS UNROLL
+        if (CFG::policy::shared(LEVEL))
+            merge_node_shared<T, fanin, N, CFG::nout>(in + g*fanin, out[g]);
+        else if (!CFG::policy::inlined(LEVEL))
+            merge_node<T, fanin, N, CFG::nout>(in + g*fanin, out[g]);
+        else
+            merge_node_inline<T, fanin, N, CFG::nout>(in + g*fanin, out[g]);
+    }
+    mergeLevels<T, nnodes, size, CFG, LEVEL+1>::run(out, merged);
+}
+
+// ------------------------------------------------------------------
+// Merger: merge the NSUB sorted arrays of the orderer (the first CFG::nout only, if set)
+template<unsigned int NIN, unsigned int NSUB, typename T = Puppi, typename CFG = MergeTree<>>
+void merger (const T ordered[NSUB][Geometry<NIN, NSUB>::nsplit], T merged[CFG::outputs(NIN)])
+{
+    #pragma HLS ARRAY_PARTITION variable=ordered complete dim=2
+    #pragma HLS ARRAY_PARTITION variable=merged  complete
+    typedef mergeLevels<T, NSUB, Geometry<NIN, NSUB>::nsplit, CFG> tree;
+    static_assert(tree::output == CFG::outputs(NIN), "merge tree truncated below the requested outputs");
+    tree::run(ordered, merged);
+}
+
+// Merge tree of the selection: only the first NPUPPI_SEL outputs are used, so each
+// sub-array contributes its NPUPPI_SEL leading candidates only and every node is a
+// topk_merge<NPUPPI_SEL>. For 8 x 26: 7 nodes of 7 + 7 -> 7 over 8 x 7 = 56 candidates,
+// 112 comparators over 12 levels in place of 1992 over 20 for the whole merge.
+typedef MergeTree<2, NPUPPI_SEL> SelectionMergeTree;
+
+// ------------------------------------------------------------------
+// Sort-key mode: only a sortkey_t per candidate goes through the networks
+//
+// The key is hwPt concatenated with the inverted candidate index, so keys are
+// unique: every compare is a single integer compare, equal-pT candidates keep
+// their input order (same result as std::stable_sort on pT) and the payload is
+// picked up once at the end by gather.
+
+// Key of candidate idx
+inline sortkey_t make_sort_key (const Puppi & p, idx_t idx)
+{
+    #pragma HLS inline
+    sortkey_t key;
+    key(sortkey_t::width-1, idx_t::width) = p.hwPt(Puppi::pt_t::width-1, 0);
+    key(idx_t::width-1, 0) = idx_t(~idx);
+    return key;
+}
+
+// Candidate index of a key
+inline idx_t sort_key_index (const sortkey_t & key)
+{
+    #pragma HLS inline
+    idx_t inv = key(idx_t::width-1, 0);
+    return idx_t(~inv);
+}
+
+// Keys of the NIN candidates sorted by decreasing pT with NSUB sub-arrays
+// (the first CFG::nout only, if set)
+template<unsigned int NIN, unsigned int NSUB, typename NET = SubArrayNetwork, typename CFG = MergeTree<>>
+void sort_keys (const Puppi slimmed[NIN], sortkey_t sorted[CFG::outputs(NIN)])
+{
+    #pragma HLS inline
+    sortkey_t keys[NIN];
+    #pragma HLS ARRAY_PARTITION variable=keys complete
+    LOOP_SORT_KEYS: for (unsigned int i = 0; i < NIN; i++)
+    {
+        #pragma HLS UNROLL
+        keys[i] = make_sort_key(slimmed[i], i);
+    }
+
+    sortkey_t ordered[NSUB][Geometry<NIN, NSUB>::nsplit];
+    orderer<NIN, NSUB, sortkey_t, NET>(keys, ordered);
+    merger<NIN, NSUB, sortkey_t, CFG>(ordered, sorted);
+}
+
+// Candidates of the first NOUT sorted keys
+template<unsigned int NIN, unsigned int NOUT>
+void gather (const Puppi slimmed[NIN], const sortkey_t sorted[NOUT], Puppi out[NOUT])
+{
+    #pragma HLS inline
+    LOOP_GATHER: for (unsigned int i = 0; i < NOUT; i++)
+    {
+        #pragma HLS UNROLL
+        out[i] = slimmed[sort_key_index(sorted[i])];
+    }
+}
+
+// ------------------------------------------------------------------
+// Top-K selection: only the NOUT largest of NIN elements, the others are never ordered
+//
+// The NIN elements are split in blocks of K (smallest power of 2 >= NOUT), each block
+// is sorted, then a tree of top-K mergers keeps the K largest of two sorted blocks:
+// max(in1[i], in2[K-1-i]) is a bitonic sequence holding the K largest of the two
+// (K comparators), which a bitonic merger of K sorts (K/2 log2(K) comparators).
+// For NPUPPI_MAX -> NPUPPI_SEL (K = 8): 26 sorters of 8 and 25 mergers, about 1000
+// comparators over 6 + 5 x 4 = 26 levels, in place of the whole 8 x 26 sort.
+template<unsigned int NIN, unsigned int NOUT>
+struct TopKGeometry {
+    static constexpr unsigned int k = hybridBitonicSort::PowerOf2LessEqualThan(2*NOUT - 1);
+    static constexpr unsigned int nblk = NIN / k;
+    static_assert(NOUT > 0 && NOUT <= NIN, "cannot select more elements than the input ones");
+    static_assert(NIN % k == 0, "input size must be a multiple of the top-K block size");
+};
+
+// Top-K tree over the COUNT sorted blocks starting at FIRST (same recursion as mergeTree,
+// COUNT needs not be a power of 2)
+template<typename T, unsigned int NBLK, unsigned int K, unsigned int FIRST, unsigned int COUNT>
+struct topKTree {
+    static void run(T blocks[NBLK][K], T top[K])
+    {
+        #pragma HLS inline
+        static constexpr unsigned int HALF = COUNT / 2;
+        T top_lo[K], top_hi[K];
+        #pragma HLS ARRAY_PARTITION variable=top_lo complete
+        #pragma HLS ARRAY_PARTITION variable=top_hi complete
+        topKTree<T, NBLK, K, FIRST, HALF>::run(blocks, top_lo);
+        topKTree<T, NBLK, K, FIRST + HALF, COUNT - HALF>::run(blocks, top_hi);
+        topk_merge<K, T>(top_lo, top_hi, top);
+    }
+};
+
+template<typename T, unsigned int NBLK, unsigned int K, unsigned int FIRST>
+struct topKTree<T, NBLK, K, FIRST, 1> {
+    static void run(T blocks[NBLK][K], T top[K])
+    {
+        #pragma HLS inline
+        for (unsigned int i = 0; i < K; i++)
+        {
+            #pragma HLS UNROLL
+            top[i] = blocks[FIRST][i];
+        }
+    }
+};
+
+// The NOUT largest elements, in descending order
+template<unsigned int NIN, unsigned int NOUT, typename T>
+void select_topk (const T in[NIN], T out[NOUT])
+{
+    #pragma HLS inline
+    static constexpr unsigned int K    = TopKGeometry<NIN, NOUT>::k;
+    static constexpr unsigned int NBLK = TopKGeometry<NIN, NOUT>::nblk;
+
+    T blocks[NBLK][K];
+    #pragma HLS ARRAY_PARTITION variable=blocks complete dim=0
+    LOOP_TOPK_SORT: for (unsigned int b = 0; b < NBLK; b++)
+    {
+        #pragma HLS UNROLL
+        for (unsigned int i = 0; i < K; i++)
+        {
+            #pragma HLS UNROLL
+            blocks[b][i] = in[i + b*K];
+        }
+        hybridBitonicSort::bitonicSorter<T, K, 0, true>::run(blocks[b], 0);
+    }
+
+    T top[K];
+    #pragma HLS ARRAY_PARTITION variable=top complete
+    topKTree<T, NBLK, K, 0, NBLK>::run(blocks, top);
+    for (unsigned int i = 0; i < NOUT; i++)
+    {
+        #pragma HLS UNROLL
+        out[i] = top[i];
+    }
+}
+
+// Keys of the NOUT leading candidates (same keys and order as the first NOUT of sort_keys)
+template<unsigned int NIN, unsigned int NOUT>
+void select_keys (const Puppi slimmed[NIN], sortkey_t top[NOUT])
+{
+    #pragma HLS inline
+    sortkey_t keys[NIN];
+    #pragma HLS ARRAY_PARTITION variable=keys complete
+    LOOP_SELECT_KEYS: for (unsigned int i = 0; i < NIN; i++)
+    {
+        #pragma HLS UNROLL
+        keys[i] = make_sort_key(slimmed[i], i);
+    }
+    select_topk<NIN, NOUT, sortkey_t>(keys, top);
+}
+
+// ------------------------------------------------------------------
+// Streaming top-K: systolic insertion chain fed with one element per clock
+//
+// Cell i holds the largest element it has seen (best[i]) and hands the other one
+// to cell i+1 at the next clock (carry[i]), so each cell does a single compare per
+// clock whatever K and the chain runs at II=1. The largest K elements are in best[],
+// in descending order, K-1 clocks (pushes of elements smaller than any real one)
+// after the last element.
+
+// Candidate travelling with its sort key through the chain
+struct KeyedPuppi {
+    sortkey_t key;
+    Puppi p;
+    inline bool operator<(const KeyedPuppi & other) const { return key < other.key; }
+};
+
+// Fill the chain with empty elements
+template<unsigned int K, typename T>
+void insertion_clear (T best[K], T carry[K], const T & empty)
+{
+    #pragma HLS inline
+    LOOP_INSERTION_CLEAR: for (unsigned int i = 0; i < K; i++)
+    {
+        #pragma HLS UNROLL
+        best[i] = empty;
+        carry[i] = empty;
+    }
+}
+
+// One clock of the chain: in enters cell 0, every cell reads the carry of the
+// previous clock (cells updated from the last one), carry[K-1] drops out
+template<unsigned int K, typename T>
+void insertion_push (T best[K], T carry[K], const T & in)
+{
+    #pragma HLS inline
+    LOOP_INSERTION_PUSH: for (int i = K-1; i >= 0; i--)
+    {
+        #pragma HLS UNROLL
+        T x = (i == 0) ? in : carry[i-1];
+        if (best[i] < x)
+        {
+            carry[i] = best[i];
+            best[i] = x;
+        }
+        else
+        {
+            carry[i] = x;
+        }
+    }
+}
+
+#endif
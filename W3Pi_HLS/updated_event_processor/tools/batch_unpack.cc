@@ -0,0 +1,93 @@
+#include "batch_unpack.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace batch_unpack {
+
+    // ------------------------------------------------------------------
+    // Sign-extend the low W bits of x
+    template<int W>
+    inline int16_t sext(uint64_t x)
+    {
+        return int16_t(int32_t(uint32_t(x << (32 - W))) >> (32 - W));
+    }
+
+    // ------------------------------------------------------------------
+    // Scalar reference: same bit ranges as Puppi::unpack
+    void unpack_scalar(const uint64_t * packed, unsigned int n,
+                       int16_t * pt, int16_t * eta, int16_t * phi, int16_t * id, int16_t * z0)
+    {
+        for (unsigned int i = 0; i < n; i++)
+        {
+            uint64_t w = packed[i];
+            pt [i] = int16_t(w & 0x3FFF);     // bits 13-0
+            eta[i] = sext<12>(w >> 14);       // bits 25-14
+            phi[i] = sext<11>(w >> 26);       // bits 36-26
+            id [i] = int16_t((w >> 37) & 0x7);// bits 39-37
+            z0 [i] = sext<10>(w >> 40);       // bits 49-40
+        }
+    }
+
+#ifdef __AVX2__
+    // ------------------------------------------------------------------
+    // Low 32 bits of (word >> shift) for 8 words (two registers of 4 x 64 bits), in order
+    template<int SHIFT>
+    inline __m256i field32(__m256i w0, __m256i w1)
+    {
+        const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+        __m256i a = _mm256_permutevar8x32_epi32(_mm256_srli_epi64(w0, SHIFT), even);
+        __m256i b = _mm256_permutevar8x32_epi32(_mm256_srli_epi64(w1, SHIFT), even);
+        return _mm256_permute2x128_si256(a, b, 0x20);
+    }
+
+    // Unsigned and signed W-bit fields as 8 x int32
+    template<int SHIFT, int W>
+    inline __m256i ufield(__m256i w0, __m256i w1)
+    {
+        return _mm256_and_si256(field32<SHIFT>(w0, w1), _mm256_set1_epi32((1 << W) - 1));
+    }
+
+    template<int SHIFT, int W>
+    inline __m256i sfield(__m256i w0, __m256i w1)
+    {
+        return _mm256_srai_epi32(_mm256_slli_epi32(field32<SHIFT>(w0, w1), 32 - W), 32 - W);
+    }
+
+    // Store 8 x int32 (all fitting in 16 bits) as 8 x int16
+    inline void store16(int16_t * out, __m256i x)
+    {
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(x, x), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(packed));
+    }
+
+    bool simd() { return true; }
+
+    void unpack(const uint64_t * packed, unsigned int n,
+                int16_t * pt, int16_t * eta, int16_t * phi, int16_t * id, int16_t * z0)
+    {
+        unsigned int i = 0;
+        for (; i + VLEN <= n; i += VLEN)
+        {
+            __m256i w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(packed + i));
+            __m256i w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(packed + i + 4));
+            store16(pt  + i, ufield< 0, 14>(w0, w1));
+            store16(eta + i, sfield<14, 12>(w0, w1));
+            store16(phi + i, sfield<26, 11>(w0, w1));
+            store16(id  + i, ufield<37,  3>(w0, w1));
+            store16(z0  + i, sfield<40, 10>(w0, w1));
+        }
+        unpack_scalar(packed + i, n - i, pt + i, eta + i, phi + i, id + i, z0 + i);
+    }
+#else
+    bool simd() { return false; }
+
+    void unpack(const uint64_t * packed, unsigned int n,
+                int16_t * pt, int16_t * eta, int16_t * phi, int16_t * id, int16_t * z0)
+    {
+        unpack_scalar(packed, n, pt, eta, phi, id, z0);
+    }
+#endif
+
+} // namespace
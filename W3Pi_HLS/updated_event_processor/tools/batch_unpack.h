@@ -0,0 +1,64 @@
+#ifndef BATCH_UNPACK_H
+#define BATCH_UNPACK_H
+
+#include <cstdint>
+
+// ------------------------------------------------------------------
+// Batch unpacking of packed Puppi words into struct-of-arrays
+//
+// Same bit layout as Puppi::pack/unpack in src/data.h:
+//  pt  : bits 13-0   unsigned, raw hwPt (LSB = 0.25 GeV)
+//  eta : bits 25-14  signed
+//  phi : bits 36-26  signed
+//  id  : bits 39-37  unsigned
+//  z0  : bits 49-40  signed
+// All fields are stored as raw int16 values, sign-extended where needed,
+// so that they are bit-identical to the ap_* fields filled by Puppi::unpack.
+// Uses AVX2 (8 words per iteration) when compiled with -mavx2, scalar code otherwise.
+namespace batch_unpack {
+
+    static constexpr unsigned int ALIGN = 32;  // bytes, one AVX2 register
+    static constexpr unsigned int VLEN = 8;    // words per vector iteration
+
+    // Round n up to a multiple of VLEN
+    constexpr unsigned int padded(unsigned int n) { return (n + VLEN - 1) / VLEN * VLEN; }
+
+    // true if the vectorized implementation was compiled in
+    bool simd();
+
+    // Unpack n words: vectorized when available, scalar fallback for the tail
+    void unpack(const uint64_t * packed, unsigned int n,
+                int16_t * pt, int16_t * eta, int16_t * phi, int16_t * id, int16_t * z0);
+
+    // Reference scalar implementation
+    void unpack_scalar(const uint64_t * packed, unsigned int n,
+                       int16_t * pt, int16_t * eta, int16_t * phi, int16_t * id, int16_t * z0);
+
+} // namespace
+
+// ------------------------------------------------------------------
+// Aligned struct-of-arrays for up to N candidates
+template<unsigned int N>
+struct PuppiSoA {
+    static constexpr unsigned int capacity = batch_unpack::padded(N);
+
+    alignas(batch_unpack::ALIGN) int16_t pt [capacity];
+    alignas(batch_unpack::ALIGN) int16_t eta[capacity];
+    alignas(batch_unpack::ALIGN) int16_t phi[capacity];
+    alignas(batch_unpack::ALIGN) int16_t id [capacity];
+    alignas(batch_unpack::ALIGN) int16_t z0 [capacity];
+    unsigned int size;
+
+    // Unpack the first min(n, N) words and zero the remaining slots
+    // (npuppi goes up to 255, the words beyond N are dropped like in the Puppi[NPUPPI_MAX] inputs)
+    void unpack(const uint64_t * packed, unsigned int n)
+    {
+        if (n > N) n = N;
+        size = n;
+        batch_unpack::unpack(packed, n, pt, eta, phi, id, z0);
+        for (unsigned int i = n; i < capacity; i++)
+            pt[i] = eta[i] = phi[i] = id[i] = z0[i] = 0;
+    }
+};
+
+#endif
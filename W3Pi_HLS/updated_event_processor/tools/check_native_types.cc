@@ -0,0 +1,255 @@
+// ------------------------------------------------------------------
+// Bit-exactness check of the native emulation types (src/native_types.h) against ap_*
+//
+// Usage:
+//   check_native_types [-n nrandom] [--seed N]
+//
+// Every arithmetic type of data.h and w3p_bdt.h is checked for the conversions
+// (from double on every quarter LSB of twice its range, from C integers, from
+// the other types) and for the expressions of the firmware (pair mass, deltaR2, dVz,
+// BDT score sum) on exhaustive or random operands. Built without -DW3P_NATIVE_TYPES,
+// so that both backends live in the same binary; returns 1 at the first mismatching check.
+#include "../src/native_types.h"
+#include "../BDT/BDT_new.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+
+// ap_* and native:: versions of one type
+#define TYPE_PAIR(name, ...) \
+    struct name { \
+        typedef ::__VA_ARGS__ ap; \
+        typedef native::__VA_ARGS__ nt; \
+        static const char * str() { return #name " = " #__VA_ARGS__; } \
+    };
+TYPE_PAIR(pt_t,    ap_ufixed<14,12,AP_RND,AP_SAT>)
+TYPE_PAIR(eta_t,   ap_int<12>)
+TYPE_PAIR(phi_t,   ap_int<11>)
+TYPE_PAIR(z0_t,    ap_int<10>)
+TYPE_PAIR(hwid_t,  ap_uint<3>)
+TYPE_PAIR(idx_t,   ap_uint<8>)
+TYPE_PAIR(dr2_t,   ap_uint<24>)
+TYPE_PAIR(cos_t,   ap_int<10>)
+TYPE_PAIR(cosh_t,  ap_uint<10>)
+TYPE_PAIR(mass_t,  ap_ufixed<15,12,AP_RND,AP_SAT>)
+TYPE_PAIR(input_t, ap_fixed<19,8,AP_RND_CONV,AP_SAT>)
+TYPE_PAIR(score_t, ap_fixed<11,4,AP_RND_CONV,AP_SAT>)
+#undef TYPE_PAIR
+
+static std::mt19937_64 rng;
+static unsigned long nrandom = 1000000;
+
+// W bits of a value, ap_* or native
+template<typename T>
+unsigned long long bits(T v)
+{
+    return v.range(T::width - 1, 0).to_uint64();
+}
+
+// Value of raw r of type P, as a double
+template<typename P>
+double value(long long r)
+{
+    return std::ldexp(double(r), P::nt::iwidth - P::nt::width);
+}
+
+// Count and print the mismatches of one check
+class Check {
+    public:
+        explicit Check(const std::string & name) : name_(name), n_(0), bad_(0) {}
+        template<typename A, typename N>
+        void operator() (const A & a, const N & n, double in)
+        {
+            n_++;
+            if (bits(a) == bits(n)) return;
+            if (bad_++ < 5) std::cout << "   " << name_ << ": input " << in << " ap " << a.to_double() << " native " << n.to_double() << std::endl;
+        }
+        bool report() const
+        {
+            std::cout << (bad_ ? " FAIL " : " ok   ") << name_ << ": " << n_ << " values, " << bad_ << " mismatches" << std::endl;
+            return bad_ == 0;
+        }
+    private:
+        std::string name_;
+        unsigned long n_, bad_;
+};
+
+// From double: every quarter LSB over twice the range (random ones for the wide types), plus random doubles
+template<typename P>
+bool check_from_double()
+{
+    typedef typename P::ap A;
+    typedef typename P::nt N;
+    Check check(std::string("from double, ") + P::str());
+    const long long span = 4LL << A::width; // quarter LSBs in twice the range
+    auto test = [&](double x) { check(A(x), N(x), x); check(A(float(x)), N(float(x)), float(x)); };
+    if (A::width <= 18)
+        for (long long k = -span; k <= span; k++) test(value<P>(k) / 4);
+    else
+        for (unsigned long i = 0; i < nrandom; i++) test(value<P>((long long)(rng() % (2 * span + 1)) - span) / 4);
+    std::uniform_real_distribution<double> uni(-2 * value<P>(1LL << A::width), 2 * value<P>(1LL << A::width));
+    for (unsigned long i = 0; i < nrandom; i++) test(uni(rng));
+    return check.report();
+}
+
+// From C integers
+template<typename P>
+bool check_from_int()
+{
+    Check check(std::string("from int, ") + P::str());
+    std::uniform_int_distribution<int> uni(-(4 << P::nt::iwidth), 4 << P::nt::iwidth);
+    for (unsigned long i = 0; i < nrandom; i++)
+    {
+        int x = uni(rng);
+        check(typename P::ap(x), typename P::nt(x), x);
+    }
+    return check.report();
+}
+
+// From type PF to type PT, on every value of PF (random beyond 2^20 values)
+template<typename PF, typename PT>
+bool check_convert()
+{
+    typedef typename PF::ap AF;
+    Check check(std::string(PF::str()) + " -> " + PT::str());
+    auto test = [&](unsigned long long r) {
+        AF a = 0;
+        typename PF::nt n = 0;
+        a.range(AF::width - 1, 0) = r;
+        n.range(AF::width - 1, 0) = r;
+        check(typename PT::ap(a), typename PT::nt(n), a.to_double());
+    };
+    if (AF::width <= 20)
+        for (unsigned long long r = 0; r < (1ULL << AF::width); r++) test(r);
+    else
+        for (unsigned long i = 0; i < nrandom; i++) test(rng() & ((1ULL << AF::width) - 1));
+    return check.report();
+}
+
+// Random value of type P, as ap_* and native
+template<typename P>
+void random_pair(typename P::ap & a, typename P::nt & n)
+{
+    unsigned long long r = rng() & ((1ULL << P::ap::width) - 1);
+    a.range(P::ap::width - 1, 0) = r;
+    n.range(P::ap::width - 1, 0) = r;
+}
+
+// get_pair_mass: 2 * pt1 * pt2 * (cosh - cos) into mass_t
+bool check_pair_mass()
+{
+    Check check("get_pair_mass");
+    for (unsigned long i = 0; i < nrandom; i++)
+    {
+        pt_t::ap pt1, pt2; pt_t::nt npt1, npt2;
+        cosh_t::ap ch; cosh_t::nt nch;
+        cos_t::ap c; cos_t::nt nc;
+        random_pair<pt_t>(pt1, npt1);
+        random_pair<pt_t>(pt2, npt2);
+        random_pair<cosh_t>(ch, nch);
+        random_pair<cos_t>(c, nc);
+        // small values too, where the rounding of the last bits shows
+        if (i & 1) { pt1 = pt1.to_double() / 64; npt1 = npt1.to_double() / 64; }
+        mass_t::ap m = 2 * pt1 * pt2 * (ch - c);
+        mass_t::nt nm = 2 * npt1 * npt2 * (nch - nc);
+        check(m, nm, pt1.to_double());
+    }
+    return check.report();
+}
+
+// deltaR2 (folded dphi, deta) into dr2_t, and dVz into z0_t, on all pairs
+bool check_deltas()
+{
+    Check check_dr2("deltaR2"), check_dvz("dVz");
+    for (int i = -1024; i < 1024; i++)
+        for (int j = -1024; j < 1024; j++)
+        {
+            phi_t::ap p1 = i, p2 = j;
+            phi_t::nt np1 = i, np2 = j;
+            auto dphi = p1 - p2;
+            auto ndphi = np1 - np2;
+            if (dphi > 360) dphi -= 720;
+            else if (dphi < -360) dphi += 720;
+            if (ndphi > 360) ndphi -= 720;
+            else if (ndphi < -360) ndphi += 720;
+            eta_t::ap e1 = 2 * i, e2 = j;
+            eta_t::nt ne1 = 2 * i, ne2 = j;
+            auto deta = e1 - e2;
+            auto ndeta = ne1 - ne2;
+            check_dr2(dr2_t::ap(dphi * dphi + deta * deta), dr2_t::nt(ndphi * ndphi + ndeta * ndeta), i);
+            if (i >= -512 && i < 512 && j >= -512 && j < 512)
+            {
+                z0_t::ap z1 = i, z2 = j;
+                z0_t::nt nz1 = i, nz2 = j;
+                check_dvz(z0_t::ap(z1 - z2), z0_t::nt(nz1 - nz2), i);
+            }
+        }
+    return check_dr2.report() && check_dvz.report();
+}
+
+// BDT::BDT::decision_function sum: init + balanced reduce of 10 tree scores, times the normalisation,
+// and the input_t <= threshold_t comparisons
+bool check_bdt()
+{
+    Check check_sum("score sum"), check_cmp("input <= threshold");
+    BDT::OpAdd<score_t::ap> add;
+    BDT::OpAdd<score_t::nt> nadd;
+    for (unsigned long i = 0; i < nrandom / 10; i++)
+    {
+        score_t::ap s[10], init, norm = 1;
+        score_t::nt ns[10], ninit, nnorm = 1;
+        for (int k = 0; k < 10; k++) random_pair<score_t>(s[k], ns[k]);
+        random_pair<score_t>(init, ninit);
+        score_t::ap y = init;
+        score_t::nt ny = ninit;
+        y += BDT::reduce<score_t::ap, 10, BDT::OpAdd<score_t::ap>>(s, add);
+        ny += BDT::reduce<score_t::nt, 10, BDT::OpAdd<score_t::nt>>(ns, nadd);
+        y *= norm;
+        ny *= nnorm;
+        check_sum(y, ny, init.to_double());
+
+        input_t::ap x, t;
+        input_t::nt nx, nt;
+        random_pair<input_t>(x, nx);
+        random_pair<input_t>(t, nt);
+        if (i & 1) { t = x; nt = nx; }
+        check_cmp(idx_t::ap(x <= t), idx_t::nt(nx <= nt), x.to_double());
+    }
+    return check_sum.report() && check_cmp.report();
+}
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-n nrandom] [--seed N]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    unsigned long seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!std::strcmp(argv[i], "-n")     && i+1 < argc) nrandom = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i+1 < argc) seed    = std::atol(argv[++i]);
+        else { usage(argv[0]); return 1; }
+    }
+    rng.seed(seed);
+
+    bool ok = true;
+    std::cout << "*** Conversions" << std::endl;
+    ok = ok && check_from_double<pt_t>()    && check_from_double<mass_t>()  && check_from_double<input_t>()
+            && check_from_double<score_t>() && check_from_double<eta_t>()   && check_from_double<cos_t>()
+            && check_from_double<cosh_t>()  && check_from_double<dr2_t>();
+    ok = ok && check_from_int<pt_t>()  && check_from_int<input_t>() && check_from_int<score_t>()
+            && check_from_int<z0_t>()  && check_from_int<idx_t>()   && check_from_int<hwid_t>();
+    ok = ok && check_convert<pt_t, input_t>()   && check_convert<mass_t, input_t>() && check_convert<dr2_t, input_t>()
+            && check_convert<z0_t, input_t>()   && check_convert<eta_t, input_t>()  && check_convert<eta_t, phi_t>()
+            && check_convert<input_t, score_t>() && check_convert<input_t, pt_t>()  && check_convert<input_t, eta_t>();
+    std::cout << "*** Firmware expressions" << std::endl;
+    ok = ok && check_pair_mass() && check_deltas() && check_bdt();
+
+    std::cout << (ok ? "*** native types are bit-exact" : "*** MISMATCH") << std::endl;
+    return ok ? 0 : 1;
+}
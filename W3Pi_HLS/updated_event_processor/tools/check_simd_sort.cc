@@ -0,0 +1,129 @@
+// ------------------------------------------------------------------
+// Check and timing of the SIMD key sort (simd_sort.h) against std::stable_sort
+//
+// Usage:
+//   check_simd_sort [-n nevents] [--seed N]
+//
+// Random events of 0..NPUPPI_MAX candidates, with few distinct pT values so that ties
+// are frequent, are ordered both by std::stable_sort on decreasing pT and by the sorted
+// fast_path::sort_key keys: the candidate indices must be the same. Random full-range
+// keys are also checked against sort_desc_scalar. The time per event of both sorts of
+// NPUPPI_MAX candidates (std::stable_sort on Puppi as in merger_ref) is printed.
+// Returns 1 at the first mismatching event.
+#include "fast_path.h"
+#include "simd_sort.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static std::mt19937 rng;
+
+// Candidate indices by decreasing pT, equal pT in input order, with both methods
+bool check_event(unsigned int n)
+{
+    int16_t pt[NPUPPI_MAX];
+    std::uniform_int_distribution<int> coarse(0, 40);
+    for (unsigned int i = 0; i < n; i++) pt[i] = int16_t(coarse(rng) * (rng() % 2 ? 1 : 397));
+
+    std::vector<unsigned int> ref(n);
+    for (unsigned int i = 0; i < n; i++) ref[i] = i;
+    std::stable_sort(ref.begin(), ref.end(), [&](unsigned int a, unsigned int b) { return pt[a] > pt[b]; });
+
+    uint32_t keys[NPUPPI_MAX];
+    for (unsigned int i = 0; i < n; i++) keys[i] = fast_path::sort_key(pt[i], i);
+    simd_sort::sort_desc(keys, n);
+
+    for (unsigned int i = 0; i < n; i++)
+        if (fast_path::key_index(keys[i]) != ref[i]) return false;
+    return true;
+}
+
+// Any keys, against the scalar sort
+bool check_keys(unsigned int n)
+{
+    uint32_t keys[simd_sort::MAX_KEYS], ref[simd_sort::MAX_KEYS];
+    for (unsigned int i = 0; i < n; i++) keys[i] = ref[i] = (rng() % 4) ? rng() : rng() % 8;
+    simd_sort::sort_desc(keys, n);
+    simd_sort::sort_desc_scalar(ref, n);
+    return std::equal(keys, keys + n, ref);
+}
+
+bool puppiGreater(const Puppi & a, const Puppi & b)
+{
+    return a.hwPt > b.hwPt;
+}
+
+// Seconds per event of each sort of NPUPPI_MAX candidates
+void timing(unsigned long nevents)
+{
+    const unsigned int NEV = 64;
+    std::vector<Puppi> events(NEV * NPUPPI_MAX);
+    for (Puppi & p : events)
+    {
+        p.clear();
+        p.hwPt = (rng() % 400) * 0.25;
+    }
+
+    Puppi work[NPUPPI_MAX];
+    unsigned long check = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned long e = 0; e < nevents; e++)
+    {
+        std::copy_n(&events[(e % NEV) * NPUPPI_MAX], NPUPPI_MAX, work);
+        std::stable_sort(work, work + NPUPPI_MAX, puppiGreater);
+        check += work[0].hwPt.to_int();
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (unsigned long e = 0; e < nevents; e++)
+    {
+        const Puppi * in = &events[(e % NEV) * NPUPPI_MAX];
+        uint32_t keys[NPUPPI_MAX];
+        for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+            keys[i] = fast_path::sort_key(ap_uint<14>(in[i].hwPt(13,0)).to_int(), i);
+        simd_sort::sort_desc(keys, NPUPPI_MAX);
+        check -= in[fast_path::key_index(keys[0])].hwPt.to_int();
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    double tStable = std::chrono::duration<double>(t1 - t0).count() / nevents;
+    double tKeys   = std::chrono::duration<double>(t2 - t1).count() / nevents;
+    std::cout << "*** std::stable_sort of " << NPUPPI_MAX << " Puppi: " << tStable * 1e6 << " us/event" << std::endl;
+    std::cout << "*** keys + " << simd_sort::isa() << " sort_desc:   " << tKeys * 1e6 << " us/event ("
+              << tStable / tKeys << "x)" << (check ? " (leading pT differs!)" : "") << std::endl;
+}
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-n nevents] [--seed N]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    unsigned long nevents = 100000, seed = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!std::strcmp(argv[i], "-n")     && i+1 < argc) nevents = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--seed") && i+1 < argc) seed    = std::atol(argv[++i]);
+        else { usage(argv[0]); return 1; }
+    }
+    rng.seed(seed);
+
+    unsigned long nbad = 0;
+    for (unsigned long e = 0; e < nevents && !nbad; e++)
+    {
+        unsigned int n = e < NPUPPI_MAX + 1 ? e : rng() % (NPUPPI_MAX + 1);
+        if (!check_event(n)) { std::cout << " FAIL event " << e << " (" << n << " candidates)" << std::endl; nbad++; }
+        unsigned int m = e <= simd_sort::MAX_KEYS ? e : rng() % (simd_sort::MAX_KEYS + 1);
+        if (!check_keys(m)) { std::cout << " FAIL keys " << e << " (" << m << " keys)" << std::endl; nbad++; }
+    }
+    std::cout << (nbad ? "*** MISMATCH" : "*** same order as std::stable_sort") << " (" << simd_sort::isa() << ", "
+              << nevents << " events)" << std::endl;
+
+    timing(nevents);
+    return nbad ? 1 : 0;
+}
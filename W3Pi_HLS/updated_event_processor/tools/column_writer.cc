@@ -0,0 +1,123 @@
+#include "column_writer.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// ------------------------------------------------------------------
+// Create the output directory
+ColumnWriter::ColumnWriter(const std::string & dirname) :
+    dirname_(dirname), nrows_(0), open_(true)
+{
+    if (mkdir(dirname.c_str(), 0755) != 0 && errno != EEXIST)
+        throw std::runtime_error("ColumnWriter: cannot create " + dirname + ": " + std::strerror(errno));
+}
+
+ColumnWriter::~ColumnWriter()
+{
+    try { if (open_) close(); }
+    catch (const std::exception & e) { std::fprintf(stderr, "%s\n", e.what()); }
+}
+
+size_t ColumnWriter::typeSize(Type type)
+{
+    switch (type)
+    {
+        case U8:  return 1;
+        case U16: return 2;
+        case U32: return 4;
+        case U64: return 8;
+        case F32: return 4;
+    }
+    return 0;
+}
+
+const char * ColumnWriter::typeName(Type type)
+{
+    switch (type)
+    {
+        case U8:  return "uint8";
+        case U16: return "uint16";
+        case U32: return "uint32";
+        case U64: return "uint64";
+        case F32: return "float32";
+    }
+    return "";
+}
+
+// ------------------------------------------------------------------
+// Declare a new column and create (truncate) its file
+int ColumnWriter::addColumn(const std::string & name, Type type, unsigned int width)
+{
+    if (nrows_.load() != 0)
+        throw std::runtime_error("ColumnWriter: cannot add column " + name + " after writing rows");
+
+    std::string fname = dirname_ + "/" + name + ".bin";
+    int fd = open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        throw std::runtime_error("ColumnWriter: cannot open " + fname + ": " + std::strerror(errno));
+
+    Column col;
+    col.name = name;
+    col.type = type;
+    col.width = width;
+    col.rowBytes = typeSize(type) * width;
+    col.fd = fd;
+    columns_.push_back(col);
+    return columns_.size() - 1;
+}
+
+uint64_t ColumnWriter::reserve(uint64_t nrows)
+{
+    return nrows_.fetch_add(nrows);
+}
+
+// ------------------------------------------------------------------
+// Positional write: thread-safe as long as threads write disjoint rows
+void ColumnWriter::write(int column, uint64_t firstRow, uint64_t nrows, const void * data)
+{
+    const Column & col = columns_[column];
+    const char * buf = static_cast<const char *>(data);
+    size_t bytes = nrows * col.rowBytes;
+    off_t offset = firstRow * col.rowBytes;
+    while (bytes > 0)
+    {
+        ssize_t written = pwrite(col.fd, buf, bytes, offset);
+        if (written < 0)
+        {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("ColumnWriter: error writing column " + col.name + ": " + std::strerror(errno));
+        }
+        buf += written;
+        bytes -= written;
+        offset += written;
+    }
+}
+
+// ------------------------------------------------------------------
+// Write schema and close the column files
+void ColumnWriter::close()
+{
+    open_ = false;
+    for (Column & col : columns_)
+    {
+        // Rows reserved but never written are left as zeros
+        if (ftruncate(col.fd, nrows_.load() * col.rowBytes) != 0)
+            throw std::runtime_error("ColumnWriter: cannot resize column " + col.name);
+        ::close(col.fd);
+        col.fd = -1;
+    }
+
+    std::ofstream schema(dirname_ + "/schema.txt");
+    for (const Column & col : columns_)
+        schema << col.name << " " << typeName(col.type) << " " << col.width << "\n";
+    schema << "nrows " << nrows_.load() << "\n";
+    if (!schema.good())
+        throw std::runtime_error("ColumnWriter: cannot write schema in " + dirname_);
+}
@@ -0,0 +1,62 @@
+#ifndef COLUMN_WRITER_H
+#define COLUMN_WRITER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Columnar binary output
+//
+// A dataset is a directory with:
+//  - one raw little-endian file per column, <name>.bin, holding nrows x width values back to back
+//  - schema.txt, one line per column: "<name> <type> <width>", and a last line "nrows <N>"
+// Every column file can be memory-mapped as is, e.g. in python:
+//   numpy.memmap("max_score.bin", dtype=numpy.float32).reshape(-1, width)
+//
+// Rows are reserved atomically and written with positional writes, so that several
+// threads can append to the same dataset concurrently without locks.
+class ColumnWriter {
+    public:
+        enum Type { U8, U16, U32, U64, F32 };
+
+        explicit ColumnWriter(const std::string & dirname);
+        ~ColumnWriter();
+
+        ColumnWriter(const ColumnWriter &) = delete;
+        ColumnWriter & operator = (const ColumnWriter &) = delete;
+
+        // Declare a column of width values per row, returns its id (only before the first reserve)
+        int addColumn(const std::string & name, Type type, unsigned int width = 1);
+
+        // Reserve nrows consecutive rows, returns the first one
+        uint64_t reserve(uint64_t nrows);
+
+        // Write rows [firstRow, firstRow+nrows) of a column from a contiguous buffer of nrows x width values
+        void write(int column, uint64_t firstRow, uint64_t nrows, const void * data);
+
+        // Flush the schema with the final number of rows and close all files
+        void close();
+
+        uint64_t nrows() const { return nrows_.load(); }
+
+    private:
+        struct Column {
+            std::string name;
+            Type type;
+            unsigned int width;
+            size_t rowBytes;
+            int fd;
+        };
+
+        static size_t typeSize(Type type);
+        static const char * typeName(Type type);
+
+        std::string dirname_;
+        std::vector<Column> columns_;
+        std::atomic<uint64_t> nrows_;
+        bool open_;
+};
+
+#endif
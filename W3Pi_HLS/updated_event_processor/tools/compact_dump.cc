@@ -0,0 +1,260 @@
+#include "compact_dump.h"
+#include "dump_reader.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace compact_dump {
+
+    // ------------------------------------------------------------------
+    // Contiguous runs of set bits of a mask: bits [shift, shift+width) of a word
+    // go to bits [dest, dest+width) of the packed value
+    struct BitRuns {
+        unsigned int n;
+        unsigned int shift[32];
+        unsigned int width[32];
+        unsigned int dest[32];
+    };
+
+    inline uint64_t lowMask(unsigned int width)
+    {
+        return width >= 64 ? ~uint64_t(0) : (uint64_t(1) << width) - 1;
+    }
+
+    BitRuns bitRuns(uint64_t mask)
+    {
+        BitRuns runs;
+        runs.n = 0;
+        unsigned int dest = 0;
+        for (unsigned int bit = 0; bit < 64; )
+        {
+            if (!((mask >> bit) & 1)) { bit++; continue; }
+            unsigned int width = 0;
+            while (bit + width < 64 && ((mask >> (bit + width)) & 1)) width++;
+            runs.shift[runs.n] = bit;
+            runs.width[runs.n] = width;
+            runs.dest[runs.n] = dest;
+            runs.n++;
+            dest += width;
+            bit += width;
+        }
+        return runs;
+    }
+
+    inline uint64_t compress(uint64_t word, const BitRuns & runs)
+    {
+        uint64_t v = 0;
+        for (unsigned int r = 0; r < runs.n; r++)
+            v |= ((word >> runs.shift[r]) & lowMask(runs.width[r])) << runs.dest[r];
+        return v;
+    }
+
+    inline uint64_t expand(uint64_t v, const BitRuns & runs)
+    {
+        uint64_t word = 0;
+        for (unsigned int r = 0; r < runs.n; r++)
+            word |= ((v >> runs.dest[r]) & lowMask(runs.width[r])) << runs.shift[r];
+        return word;
+    }
+
+    // ------------------------------------------------------------------
+    // Value i of a stream of width-bit values
+    inline uint64_t extract(const uint64_t * in, unsigned int i, unsigned int width)
+    {
+        uint64_t bit = uint64_t(i) * width;
+        unsigned int k = bit >> 6, sh = bit & 63;
+        uint64_t v = in[k] >> sh;
+        if (sh + width > 64) v |= in[k+1] << (64 - sh);
+        return v & lowMask(width);
+    }
+
+    std::string compactName(const std::string & dumpName)
+    {
+        size_t dot = dumpName.find_last_of('.');
+        size_t slash = dumpName.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return dumpName + ".cdump";
+        return dumpName.substr(0, dot) + ".cdump";
+    }
+
+    bool isCompact(const void * data, size_t bytes)
+    {
+        return bytes >= sizeof(FileHeader) && std::memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+    }
+
+    // ------------------------------------------------------------------
+    // Mask word, then the candidates packed at popcount(mask) bits
+    size_t encodeEvent(const uint64_t * cands, unsigned int n, uint64_t * out)
+    {
+        if (n == 0) return 0;
+
+        uint64_t mask = 0;
+        for (unsigned int i = 0; i < n; i++) mask |= cands[i];
+        BitRuns runs = bitRuns(mask);
+        unsigned int width = __builtin_popcountll(mask);
+        size_t nw = packedWords(n, width);
+
+        out[0] = mask;
+        uint64_t * packed = out + 1;
+        std::memset(packed, 0, nw * sizeof(uint64_t));
+        for (unsigned int i = 0; i < n; i++)
+        {
+            uint64_t v = compress(cands[i], runs);
+            uint64_t bit = uint64_t(i) * width;
+            unsigned int k = bit >> 6, sh = bit & 63;
+            packed[k] |= v << sh;
+            if (sh + width > 64) packed[k+1] |= v >> (64 - sh);
+        }
+        return 1 + nw;
+    }
+
+#ifdef __AVX2__
+    bool simd() { return true; }
+
+    // ------------------------------------------------------------------
+    // 4 candidates at a time: gather the (one or two) words holding each value,
+    // funnel shift, then scatter the runs back to their original bit positions
+    size_t decodeEvent(const uint64_t * in, unsigned int n, uint64_t * out)
+    {
+        if (n == 0) return 0;
+
+        uint64_t mask = in[0];
+        BitRuns runs = bitRuns(mask);
+        unsigned int width = __builtin_popcountll(mask);
+        size_t nw = packedWords(n, width);
+        const uint64_t * packed = in + 1;
+
+        unsigned int i = 0;
+        if (width > 0)
+        {
+            const __m256i vmask = _mm256_set1_epi64x(lowMask(width));
+            const __m256i v64 = _mm256_set1_epi64x(64);
+            const long long * base = reinterpret_cast<const long long *>(packed);
+            for (; i + 4 <= n; i += 4)
+            {
+                alignas(32) long long lo[4], hi[4], sh[4];
+                for (unsigned int j = 0; j < 4; j++)
+                {
+                    uint64_t bit = uint64_t(i + j) * width;
+                    lo[j] = bit >> 6;
+                    // the second word is only used when the value spans two words, and is masked away otherwise
+                    hi[j] = (lo[j] + 1 < (long long)nw) ? lo[j] + 1 : lo[j];
+                    sh[j] = bit & 63;
+                }
+                __m256i vsh = _mm256_load_si256(reinterpret_cast<const __m256i *>(sh));
+                __m256i wlo = _mm256_i64gather_epi64(base, _mm256_load_si256(reinterpret_cast<const __m256i *>(lo)), 8);
+                __m256i whi = _mm256_i64gather_epi64(base, _mm256_load_si256(reinterpret_cast<const __m256i *>(hi)), 8);
+                // sllv by 64 gives 0, as needed for sh = 0
+                __m256i v = _mm256_or_si256(_mm256_srlv_epi64(wlo, vsh), _mm256_sllv_epi64(whi, _mm256_sub_epi64(v64, vsh)));
+                v = _mm256_and_si256(v, vmask);
+
+                __m256i word = _mm256_setzero_si256();
+                for (unsigned int r = 0; r < runs.n; r++)
+                {
+                    __m256i f = _mm256_and_si256(_mm256_srl_epi64(v, _mm_cvtsi32_si128(runs.dest[r])),
+                                                 _mm256_set1_epi64x(lowMask(runs.width[r])));
+                    word = _mm256_or_si256(word, _mm256_sll_epi64(f, _mm_cvtsi32_si128(runs.shift[r])));
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), word);
+            }
+        }
+        for (; i < n; i++)
+            out[i] = width > 0 ? expand(extract(packed, i, width), runs) : 0;
+        return 1 + nw;
+    }
+#else
+    bool simd() { return false; }
+
+    size_t decodeEvent(const uint64_t * in, unsigned int n, uint64_t * out)
+    {
+        if (n == 0) return 0;
+
+        uint64_t mask = in[0];
+        BitRuns runs = bitRuns(mask);
+        unsigned int width = __builtin_popcountll(mask);
+        const uint64_t * packed = in + 1;
+        for (unsigned int i = 0; i < n; i++)
+            out[i] = width > 0 ? expand(extract(packed, i, width), runs) : 0;
+        return 1 + packedWords(n, width);
+    }
+#endif
+
+    // ------------------------------------------------------------------
+    // .dump words -> .cdump words
+    void encode(const uint64_t * dump, size_t nwords, std::vector<uint64_t> & out)
+    {
+        out.assign(sizeof(FileHeader) / sizeof(uint64_t), 0);
+        out.reserve(nwords);
+
+        uint64_t nevents = 0;
+        size_t pos = 0;
+        while (pos < nwords)
+        {
+            unsigned int n = EventHeader::decode(dump[pos]).npuppi;
+            if (pos + 1 + n > nwords)
+                throw std::runtime_error("compact_dump: truncated event at word " + std::to_string(pos));
+
+            size_t start = out.size();
+            out.resize(start + 2 + n);
+            out[start] = dump[pos];
+            size_t used = encodeEvent(dump + pos + 1, n, out.data() + start + 1);
+            out.resize(start + 1 + used);
+
+            pos += 1 + n;
+            nevents++;
+        }
+
+        FileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.reserved = 0;
+        header.nevents = nevents;
+        header.dump_size = nwords * sizeof(uint64_t);
+        std::memcpy(out.data(), &header, sizeof(header));
+    }
+
+    // ------------------------------------------------------------------
+    // .cdump words -> .dump words
+    void decode(const uint64_t * cdump, size_t nwords, std::vector<uint64_t> & out)
+    {
+        if (!isCompact(cdump, nwords * sizeof(uint64_t)))
+            throw std::runtime_error("compact_dump: not a compact dump");
+        FileHeader header;
+        std::memcpy(&header, cdump, sizeof(header));
+        if (header.version != VERSION)
+            throw std::runtime_error("compact_dump: unsupported version " + std::to_string(header.version));
+
+        // the header is untrusted: an empty event takes one word and decodes to one, any other event
+        // takes at least header + mask words and decodes to at most 1 + 255, so at most 128x the payload
+        size_t payload = nwords - sizeof(FileHeader) / sizeof(uint64_t);
+        if (header.nevents > payload || header.dump_size % sizeof(uint64_t) != 0 ||
+            header.dump_size / sizeof(uint64_t) > 128 * uint64_t(payload))
+            throw std::runtime_error("compact_dump: declared size " + std::to_string(header.dump_size) +
+                                     " inconsistent with the file size");
+
+        out.resize(header.dump_size / sizeof(uint64_t));
+        size_t pos = sizeof(FileHeader) / sizeof(uint64_t), opos = 0;
+        for (uint64_t ievt = 0; ievt < header.nevents; ievt++)
+        {
+            if (pos >= nwords)
+                throw std::runtime_error("compact_dump: truncated file at event " + std::to_string(ievt));
+            unsigned int n = EventHeader::decode(cdump[pos]).npuppi;
+            if (opos + 1 + n > out.size())
+                throw std::runtime_error("compact_dump: event " + std::to_string(ievt) + " exceeds the declared size");
+            // the mask word tells the packed size, check it before touching the payload
+            if (n > 0 && (pos + 1 >= nwords || pos + 2 + packedWords(n, __builtin_popcountll(cdump[pos+1])) > nwords))
+                throw std::runtime_error("compact_dump: truncated event " + std::to_string(ievt));
+
+            out[opos] = cdump[pos];
+            pos += 1 + decodeEvent(cdump + pos + 1, n, out.data() + opos + 1);
+            opos += 1 + n;
+        }
+        if (opos != out.size() || pos != nwords)
+            throw std::runtime_error("compact_dump: inconsistent file size");
+    }
+
+} // namespace
@@ -0,0 +1,63 @@
+#ifndef COMPACT_DUMP_H
+#define COMPACT_DUMP_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Compact bit-packed dump: Puppi_xxx.dump <-> Puppi_xxx.cdump (lossless)
+//
+// Layout (little endian, 64-bit words):
+//  - FileHeader (32 bytes)
+//  - for each event:
+//      header word, unchanged
+//      if npuppi > 0: mask word = OR of all candidate words of the event
+//                     npuppi x popcount(mask) bits, candidate i at bit i*popcount(mask)
+//                     (only the bits set in mask are kept), padded to a full word
+//
+// Puppi::pack fills bits 49-0 only (50 bits, -22%), while the scouting words also use
+// some of bits 61-50 (e.g. quality bits of charged candidates): the per-event mask keeps
+// the format lossless for both, at the cost of one word per event.
+// Every event starts on a word boundary, so events can be decoded independently.
+namespace compact_dump {
+
+    static constexpr char MAGIC[8] = {'W','3','P','I','C','M','P','\0'};
+    static constexpr uint32_t VERSION = 1;
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t nevents;
+        uint64_t dump_size;   // bytes of the equivalent .dump
+    };
+
+    static_assert(sizeof(FileHeader) == 32, "unexpected FileHeader padding");
+
+    // Compact name: extension of the dump replaced by .cdump
+    std::string compactName(const std::string & dumpName);
+
+    // True if the buffer starts with a compact file header
+    bool isCompact(const void * data, size_t bytes);
+
+    // Words used by n candidates packed at width bits
+    inline size_t packedWords(unsigned int n, unsigned int width) { return (uint64_t(n) * width + 63) / 64; }
+
+    // Encode the n candidates of one event into out (at most n+1 words), returns the words written
+    size_t encodeEvent(const uint64_t * cands, unsigned int n, uint64_t * out);
+
+    // Decode the n candidates of one event into out, returns the words read from in
+    size_t decodeEvent(const uint64_t * in, unsigned int n, uint64_t * out);
+
+    // Whole-file conversion (throws std::runtime_error on malformed input)
+    void encode(const uint64_t * dump, size_t nwords, std::vector<uint64_t> & out);
+    void decode(const uint64_t * cdump, size_t nwords, std::vector<uint64_t> & out);
+
+    // True if decodeEvent was compiled with AVX2
+    bool simd();
+
+} // namespace
+
+#endif
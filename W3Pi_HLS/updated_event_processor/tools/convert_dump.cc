@@ -0,0 +1,77 @@
+// ------------------------------------------------------------------
+// Convert between .dump and the compact .cdump format (see compact_dump.h)
+//
+// Usage:
+//   convert_dump input.dump  [output.cdump]
+//   convert_dump input.cdump [output.dump]
+// The direction is given by the content of the input file.
+#include "compact_dump.h"
+#include "dump_reader.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Read a whole file as 64-bit words
+std::vector<uint64_t> readWords(const std::string & fname)
+{
+    std::ifstream in(fname, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.good()) throw std::runtime_error("cannot open " + fname);
+    size_t bytes = in.tellg();
+    if (bytes % sizeof(uint64_t) != 0) throw std::runtime_error("size of " + fname + " is not a multiple of 64 bits");
+    std::vector<uint64_t> words(bytes / sizeof(uint64_t));
+    in.seekg(0);
+    in.read(reinterpret_cast<char *>(words.data()), bytes);
+    return words;
+}
+
+int main(int argc, char **argv) {
+
+    if (argc < 2 || argc > 3)
+    {
+        std::cout << "Usage: " << argv[0] << " input.(c)dump [output]" << std::endl;
+        return 1;
+    }
+    std::string inName = argv[1];
+
+    try
+    {
+        std::vector<uint64_t> in = readWords(inName);
+        bool compact = compact_dump::isCompact(in.data(), in.size() * sizeof(uint64_t));
+
+        std::string outName;
+        if (argc == 3) outName = argv[2];
+        else if (compact) outName = inName.substr(0, inName.find_last_of('.')) + ".dump";
+        else outName = compact_dump::compactName(inName);
+        if (outName == inName)
+        {
+            std::cout << "Output would overwrite the input " << inName << std::endl;
+            return 1;
+        }
+
+        std::vector<uint64_t> out;
+        auto start = std::chrono::steady_clock::now();
+        if (compact) compact_dump::decode(in.data(), in.size(), out);
+        else         compact_dump::encode(in.data(), in.size(), out);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::ofstream fout(outName, std::ios::out | std::ios::binary);
+        fout.write(reinterpret_cast<const char *>(out.data()), out.size() * sizeof(uint64_t));
+        fout.close();
+        if (!fout.good()) throw std::runtime_error("error writing " + outName);
+
+        std::cout << "*** " << inName << " (" << in.size() * 8 << " bytes) -> " << outName << " (" << out.size() * 8 << " bytes)"
+                  << ", " << (compact ? "decoded" : "encoded") << " in " << seconds << " s"
+                  << (compact_dump::simd() ? " (AVX2)" : "") << std::endl;
+    }
+    catch (const std::exception & e)
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
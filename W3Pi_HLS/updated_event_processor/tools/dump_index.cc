@@ -0,0 +1,187 @@
+#include "dump_index.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace dump_index {
+
+    // ------------------------------------------------------------------
+    // Sidecar name: Puppi_xxx.dump -> Puppi_xxx.idx
+    std::string indexName(const std::string & dumpName)
+    {
+        size_t dot = dumpName.find_last_of('.');
+        size_t slash = dumpName.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            return dumpName + ".idx";
+        return dumpName.substr(0, dot) + ".idx";
+    }
+
+    // ------------------------------------------------------------------
+    // Hash of the sampled header words
+    uint64_t headerHash(const uint64_t * words, const std::vector<EventInfo> & index)
+    {
+        uint64_t hash = 14695981039346656037ULL;
+        size_t nsamples = std::min(index.size(), HASH_SAMPLES);
+        for (size_t k = 0; k < nsamples; k++)
+        {
+            size_t i = nsamples > 1 ? k * (index.size() - 1) / (nsamples - 1) : 0;
+            uint64_t word = words[index[i].offset];
+            for (unsigned int b = 0; b < 8; b++)
+            {
+                hash ^= (word >> (8*b)) & 0xFF;
+                hash *= 1099511628211ULL;
+            }
+        }
+        return hash;
+    }
+
+    // ------------------------------------------------------------------
+    // Write index file
+    void write(const std::string & idxName, const std::vector<EventInfo> & index, const uint64_t * words, uint64_t nwords)
+    {
+        FILE * f = std::fopen(idxName.c_str(), "wb");
+        if (!f) throw std::runtime_error("dump_index: cannot write " + idxName);
+
+        IndexFileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version     = VERSION;
+        header.record_size = sizeof(IndexRecord);
+        header.nevents     = index.size();
+        header.dump_size   = nwords * sizeof(uint64_t);
+        header.header_hash = headerHash(words, index);
+        bool ok = std::fwrite(&header, sizeof(header), 1, f) == 1;
+
+        // Write records in blocks
+        static constexpr size_t BLOCK = 4096;
+        std::vector<IndexRecord> block;
+        block.reserve(BLOCK);
+        for (size_t i = 0; ok && i < index.size(); i++)
+        {
+            const EventInfo & info = index[i];
+            IndexRecord rec;
+            rec.offset = info.offset;
+            rec.orbit  = info.orbit;
+            rec.bx     = info.bx;
+            rec.npuppi = info.npuppi;
+            rec.flags  = (info.run & 0x1F) | (info.error ? 0x20 : 0);
+            block.push_back(rec);
+
+            if (block.size() == BLOCK || i + 1 == index.size())
+            {
+                ok = std::fwrite(block.data(), sizeof(IndexRecord), block.size(), f) == block.size();
+                block.clear();
+            }
+        }
+
+        if (std::fclose(f) != 0 || !ok)
+            throw std::runtime_error("dump_index: error writing " + idxName);
+    }
+
+    // ------------------------------------------------------------------
+    // Read index file, checking it matches the dump it was built from
+    bool read(const std::string & idxName, const uint64_t * words, uint64_t nwords, std::vector<EventInfo> & index)
+    {
+        FILE * f = std::fopen(idxName.c_str(), "rb");
+        if (!f) return false;
+
+        const uint64_t dumpSize = nwords * sizeof(uint64_t);
+        IndexFileHeader header;
+        bool ok = std::fread(&header, sizeof(header), 1, f) == 1
+               && std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0
+               && header.version == VERSION
+               && header.record_size == sizeof(IndexRecord)
+               && header.dump_size == dumpSize;
+
+        // The records must fill the rest of the file (before allocating nevents of them)
+        if (ok)
+        {
+            long pos = std::ftell(f);
+            ok = std::fseek(f, 0, SEEK_END) == 0;
+            long size = std::ftell(f);
+            ok = ok && pos >= 0 && size >= pos
+                    && header.nevents == uint64_t(size - pos) / sizeof(IndexRecord)
+                    && uint64_t(size - pos) % sizeof(IndexRecord) == 0
+                    && std::fseek(f, pos, SEEK_SET) == 0;
+        }
+
+        std::vector<IndexRecord> records;
+        if (ok)
+        {
+            records.resize(header.nevents);
+            ok = std::fread(records.data(), sizeof(IndexRecord), records.size(), f) == records.size();
+        }
+        std::fclose(f);
+        if (!ok) return false;
+
+        // Records must tile the whole dump
+        uint64_t pos = 0;
+        for (const IndexRecord & rec : records)
+        {
+            if (rec.offset != pos) return false;
+            pos += 1 + rec.npuppi;
+        }
+        if (pos * sizeof(uint64_t) != dumpSize) return false;
+
+        std::vector<EventInfo> decoded;
+        decoded.reserve(records.size());
+        for (const IndexRecord & rec : records)
+        {
+            EventInfo info;
+            info.offset = rec.offset;
+            info.npuppi = rec.npuppi;
+            info.bx     = rec.bx;
+            info.orbit  = rec.orbit;
+            info.run    = rec.flags & 0x1F;
+            info.error  = rec.flags & 0x20;
+            decoded.push_back(info);
+        }
+
+        // Same header words at the sampled events: not an index of another dump of the same size
+        if (headerHash(words, decoded) != header.header_hash) return false;
+
+        index.swap(decoded);
+        return true;
+    }
+
+    // ------------------------------------------------------------------
+    // Balanced sharding on the cumulative number of words (header + candidates)
+    std::vector<std::pair<size_t, size_t>> balancedShards(const std::vector<EventInfo> & index, unsigned int nshards)
+    {
+        std::vector<uint64_t> cumul(index.size() + 1, 0);
+        for (size_t i = 0; i < index.size(); i++)
+            cumul[i+1] = cumul[i] + 1 + index[i].npuppi;
+
+        std::vector<std::pair<size_t, size_t>> shards;
+        size_t begin = 0;
+        for (unsigned int is = 0; is < nshards; is++)
+        {
+            uint64_t target = cumul.back() * (is + 1) / nshards;
+            size_t end = std::lower_bound(cumul.begin() + begin, cumul.end(), target) - cumul.begin();
+            if (is + 1 == nshards) end = index.size();
+            shards.push_back(std::make_pair(begin, end));
+            begin = end;
+        }
+        return shards;
+    }
+
+    // ------------------------------------------------------------------
+    // Event selection by orbit/bunch crossing
+    std::vector<size_t> selectOrbit(const std::vector<EventInfo> & index, unsigned int orbit)
+    {
+        std::vector<size_t> selected;
+        for (size_t i = 0; i < index.size(); i++)
+            if (index[i].orbit == orbit) selected.push_back(i);
+        return selected;
+    }
+
+    std::vector<size_t> selectBx(const std::vector<EventInfo> & index, unsigned int bx)
+    {
+        std::vector<size_t> selected;
+        for (size_t i = 0; i < index.size(); i++)
+            if (index[i].bx == bx) selected.push_back(i);
+        return selected;
+    }
+
+} // namespace
@@ -0,0 +1,69 @@
+#ifndef DUMP_INDEX_H
+#define DUMP_INDEX_H
+
+#include "dump_reader.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Sidecar event index of a dump file: Puppi_xxx.dump -> Puppi_xxx.idx
+//
+// Layout (little endian):
+//  - IndexFileHeader (40 bytes)
+//  - nevents x IndexRecord (16 bytes each), in file order
+//
+// Event N is found in O(1) at byte 8*offset of the dump, and the candidate
+// counts allow balanced sharding without touching the dump. An index is stale
+// unless its records tile the dump and the dump has the same size and the same
+// header words at the sampled events (headerHash).
+namespace dump_index {
+
+    static constexpr char MAGIC[8] = {'W','3','P','I','I','D','X','\0'};
+    static constexpr uint32_t VERSION = 2;
+    static constexpr size_t HASH_SAMPLES = 256;  // event headers in headerHash
+
+    struct IndexFileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t nevents;
+        uint64_t dump_size;   // bytes of the indexed dump, to detect stale indexes
+        uint64_t header_hash; // headerHash of the indexed dump, to detect stale indexes
+    };
+
+    struct IndexRecord {
+        uint64_t offset;      // header position, in 64-bit words
+        uint32_t orbit;
+        uint16_t bx;
+        uint8_t  npuppi;
+        uint8_t  flags;       // bits 4-0: run number, bit 5: error bit
+    };
+
+    static_assert(sizeof(IndexFileHeader) == 40, "unexpected IndexFileHeader padding");
+    static_assert(sizeof(IndexRecord) == 16, "unexpected IndexRecord padding");
+
+    // Sidecar name: extension of the dump replaced by .idx
+    std::string indexName(const std::string & dumpName);
+
+    // FNV-1a hash of the header words of HASH_SAMPLES evenly spaced events (first and last
+    // included): O(1) in the dump size, and the same for a dump and its compact version
+    uint64_t headerHash(const uint64_t * words, const std::vector<EventInfo> & index);
+
+    // Write/read the index of a dump (nwords 64-bit words, decoded if compact); read returns
+    // false if missing, corrupted or stale
+    void write(const std::string & idxName, const std::vector<EventInfo> & index, const uint64_t * words, uint64_t nwords);
+    bool read(const std::string & idxName, const uint64_t * words, uint64_t nwords, std::vector<EventInfo> & index);
+
+    // Split events in nshards contiguous [begin, end) ranges with ~equal number of candidates
+    std::vector<std::pair<size_t, size_t>> balancedShards(const std::vector<EventInfo> & index, unsigned int nshards);
+
+    // Event numbers matching a given orbit or bunch crossing
+    std::vector<size_t> selectOrbit(const std::vector<EventInfo> & index, unsigned int orbit);
+    std::vector<size_t> selectBx   (const std::vector<EventInfo> & index, unsigned int bx);
+
+} // namespace
+
+#endif
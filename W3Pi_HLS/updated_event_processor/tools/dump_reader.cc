@@ -0,0 +1,159 @@
+#include "dump_reader.h"
+#include "dump_index.h"
+#include "compact_dump.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+// ------------------------------------------------------------------
+// Header decoding/encoding (see bit layout in dump_reader.h)
+EventHeader EventHeader::decode(uint64_t header)
+{
+    EventHeader h;
+    h.npuppi =  header        & 0xFF      ; // 8 bits
+    h.bx     = (header >> 12) & 0xFFF     ; // 12 bits
+    h.orbit  = (header >> 24) & 0xFFFFFFFF; // 32 bits
+    h.run    = (header >> 56) & 0x1F      ; // 5 bits
+    h.error  = (header >> 61) & 0x1       ; // 1 bit
+    h.valid  = ((header >> 62) & 0x3) == 0x2; // 2 bits
+    return h;
+}
+
+uint64_t EventHeader::encode() const
+{
+    uint64_t header = 0;
+    header |= uint64_t(npuppi & 0xFF);
+    header |= uint64_t(bx     & 0xFFF)      << 12;
+    header |= uint64_t(orbit  & 0xFFFFFFFF) << 24;
+    header |= uint64_t(run    & 0x1F)       << 56;
+    header |= uint64_t(error  ? 1 : 0)      << 61;
+    header |= uint64_t(valid  ? 2 : 0)      << 62;
+    return header;
+}
+
+// ------------------------------------------------------------------
+// Open and map the file, then build the event index
+DumpReader::DumpReader(const std::string & fname, bool useIndex) :
+    fname_(fname), fd_(-1), words_(nullptr), nwords_(0), fromSidecar_(false), compact_(false)
+{
+    fd_ = open(fname.c_str(), O_RDONLY);
+    if (fd_ < 0)
+        throw std::runtime_error("DumpReader: cannot open " + fname + ": " + std::strerror(errno));
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0)
+    {
+        close(fd_);
+        throw std::runtime_error("DumpReader: cannot stat " + fname + ": " + std::strerror(errno));
+    }
+    if (st.st_size % sizeof(uint64_t) != 0)
+    {
+        close(fd_);
+        throw std::runtime_error("DumpReader: size of " + fname + " is not a multiple of 64 bits");
+    }
+    nwords_ = st.st_size / sizeof(uint64_t);
+
+    // Empty file: nothing to map, empty index
+    if (nwords_ == 0) return;
+
+    void * addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (addr == MAP_FAILED)
+    {
+        close(fd_);
+        throw std::runtime_error("DumpReader: cannot mmap " + fname + ": " + std::strerror(errno));
+    }
+    words_ = static_cast<const uint64_t *>(addr);
+
+    // Compact file: decode it once in memory, the events are then served from the decoded copy
+    if (compact_dump::isCompact(addr, st.st_size))
+    {
+        madvise(addr, st.st_size, MADV_SEQUENTIAL);
+        try { compact_dump::decode(words_, nwords_, decoded_); }
+        catch (const std::exception & e)
+        {
+            munmap(addr, st.st_size);
+            close(fd_);
+            throw std::runtime_error("DumpReader: " + fname + ": " + e.what());
+        }
+        munmap(addr, st.st_size);
+        close(fd_);
+        fd_ = -1;
+        compact_ = true;
+        words_ = decoded_.data();
+        nwords_ = decoded_.size();
+    }
+
+    // Reuse the sidecar index if available, otherwise a single sequential pass over the headers
+    // (the sidecar of a compact file is the one of the equivalent .dump);
+    // the destructor does not run if the constructor throws, so release the mapping here
+    try
+    {
+        if (useIndex && dump_index::read(dump_index::indexName(fname), words_, nwords_, index_))
+        {
+            fromSidecar_ = true;
+        }
+        else
+        {
+            if (!compact()) madvise(addr, st.st_size, MADV_SEQUENTIAL);
+            buildIndex();
+        }
+    }
+    catch (...)
+    {
+        if (!compact())
+        {
+            munmap(addr, st.st_size);
+            close(fd_);
+        }
+        throw;
+    }
+    if (!compact()) madvise(addr, st.st_size, MADV_RANDOM);
+}
+
+DumpReader::~DumpReader()
+{
+    if (words_ && !compact()) munmap(const_cast<uint64_t *>(words_), nwords_ * sizeof(uint64_t));
+    if (fd_ >= 0) close(fd_);
+}
+
+// ------------------------------------------------------------------
+// Walk header to header: each header is followed by npuppi candidate words
+void DumpReader::buildIndex()
+{
+    index_.clear();
+    uint64_t pos = 0;
+    while (pos < nwords_)
+    {
+        EventHeader h = EventHeader::decode(words_[pos]);
+        if (pos + 1 + h.npuppi > nwords_)
+            throw std::runtime_error("DumpReader: truncated event at word " + std::to_string(pos) + " in " + fname_);
+
+        EventInfo info;
+        info.offset = pos;
+        info.npuppi = h.npuppi;
+        info.bx     = h.bx;
+        info.orbit  = h.orbit;
+        info.run    = h.run;
+        info.error  = h.error;
+        index_.push_back(info);
+
+        pos += 1 + h.npuppi;
+    }
+}
+
+// ------------------------------------------------------------------
+// Packed candidates of one event, pointing directly into the mapped file
+PuppiSpan DumpReader::event(size_t ievt) const
+{
+    const EventInfo & info = index_[ievt];
+    PuppiSpan span;
+    span.data = words_ + info.offset + 1;
+    span.size = info.npuppi;
+    return span;
+}
@@ -0,0 +1,93 @@
+#ifndef DUMP_READER_H
+#define DUMP_READER_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Scouting event header
+// bits     size    meaning
+// 63-62    2       10 = valid event header
+// 61       1       error bit
+// 60-56    5       (local) run number
+// 55-24    32      orbit number
+// 23-12    12      bunch crossing number (0-3563)
+// 11-08    4       must be set to 0
+// 07-00    8       number of Puppi candidates
+struct EventHeader {
+    unsigned int npuppi;
+    unsigned int bx;
+    unsigned int orbit;
+    unsigned int run;
+    bool error;
+    bool valid;
+
+    static EventHeader decode(uint64_t header);
+    uint64_t encode() const;
+};
+
+// ------------------------------------------------------------------
+// Zero-copy view of the packed Puppi words of one event
+struct PuppiSpan {
+    const uint64_t * data;
+    unsigned int size;
+
+    const uint64_t * begin() const { return data; }
+    const uint64_t * end()   const { return data + size; }
+    uint64_t operator [] (unsigned int i) const { return data[i]; }
+};
+
+// ------------------------------------------------------------------
+// Position and decoded header of one event in the dump
+struct EventInfo {
+    uint64_t offset;      // position of the header, in 64-bit words from the start of the file
+    unsigned int npuppi;
+    unsigned int bx;
+    unsigned int orbit;
+    unsigned int run;
+    bool error;
+};
+
+// ------------------------------------------------------------------
+// DumpReader: memory-map a Puppi_*.dump file and index all its events in one pass
+//  - if useIndex, the sidecar .idx (see dump_index.h) is loaded instead when present and up to date
+//  - compact .cdump files (see compact_dump.h) are decoded in memory when opened
+class DumpReader {
+    public:
+        explicit DumpReader(const std::string & fname, bool useIndex = true);
+        ~DumpReader();
+
+        DumpReader(const DumpReader &) = delete;
+        DumpReader & operator = (const DumpReader &) = delete;
+
+        const std::string & name() const { return fname_; }
+        size_t size() const { return index_.size(); }
+        const std::vector<EventInfo> & index() const { return index_; }
+        const EventInfo & info(size_t ievt) const { return index_[ievt]; }
+        bool fromSidecar() const { return fromSidecar_; }
+        bool compact() const { return compact_; }
+
+        // raw header word and packed candidates of event ievt
+        uint64_t header(size_t ievt) const { return words_[index_[ievt].offset]; }
+        PuppiSpan event(size_t ievt) const;
+
+        // whole file as 64-bit words
+        const uint64_t * words() const { return words_; }
+        size_t nwords() const { return nwords_; }
+
+    private:
+        void buildIndex();
+
+        std::string fname_;
+        int fd_;
+        const uint64_t * words_;
+        size_t nwords_;
+        std::vector<EventInfo> index_;
+        bool fromSidecar_;
+        bool compact_;
+        std::vector<uint64_t> decoded_; // decoded content of a compact (.cdump) file
+};
+
+#endif
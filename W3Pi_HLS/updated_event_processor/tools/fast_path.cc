@@ -0,0 +1,149 @@
+#include "fast_path.h"
+#include "simd_sort.h"
+#include "../src/coscosh_lut.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace fast_path {
+
+    // Signed value of the low bits of x (ap_int<bits> assignment)
+    template<int bits>
+    inline int wrap(int x)
+    {
+        return int(unsigned(x) << (32 - bits)) >> (32 - bits);
+    }
+
+    // ------------------------------------------------------------------
+    // Raw field values as in the firmware: masked when |eta| > ETA_CUT or ID not in [2,5]
+    void mask(PuppiBlock & block)
+    {
+        const int16_t etaMax = int16_t(Puppi::ETA_CUT); // hwEta is integer: |eta| > ETA_CUT <=> |eta| > floor(ETA_CUT)
+        for (unsigned int i = 0; i < PuppiBlock::capacity; i++)
+        {
+            bool keep = (block.eta[i] >= -etaMax) & (block.eta[i] <= etaMax) & (block.id[i] >= 2) & (block.id[i] <= 5);
+            int16_t m = -int16_t(keep);
+            block.pt [i] &= m;
+            block.eta[i] &= m;
+            block.phi[i] &= m;
+            block.id [i] &= m;
+            block.z0 [i] &= m;
+        }
+    }
+
+    // ------------------------------------------------------------------
+    // sorter7f + selector7f: same keys, sorted with the SIMD bitonic sort
+    void order(const PuppiBlock & block, uint8_t selected[NPUPPI_SEL])
+    {
+        uint32_t keys[NPUPPI_MAX];
+        for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+            keys[i] = sort_key(block.pt[i], i);
+
+        simd_sort::sort_desc(keys, NPUPPI_MAX);
+
+        for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+            selected[i] = key_index(keys[i]);
+    }
+
+    // ------------------------------------------------------------------
+    // Selected candidates as plain integers
+    struct Selected {
+        int pt[NPUPPI_SEL], eta[NPUPPI_SEL], phi[NPUPPI_SEL], id[NPUPPI_SEL], z0[NPUPPI_SEL];
+    };
+
+    inline int charge(int id)
+    {
+        return id <= 1 ? 0 : ((id & 1) ? 1 : -1);
+    }
+
+    // dphi of get_pair_mass/deltaR2: ap_int<12> difference folded once into [-INT_PI, INT_PI]
+    inline int delta_phi(int phi1, int phi2)
+    {
+        int dphi = phi1 - phi2;
+        if (dphi > Puppi::INT_PI) dphi -= Puppi::INT_2PI;
+        else if (dphi < -Puppi::INT_PI) dphi += Puppi::INT_2PI;
+        return dphi;
+    }
+
+    // get_pair_mass, in units of the mass_t LSB (1/8), with the ROMs of coscosh_lut.h
+    // (|deta| beyond the table takes the saturated last entry, as get_cosh_eta)
+    inline int pair_mass8(const Selected & s, int i, int j)
+    {
+        int iphi = std::abs(wrap<Puppi::phi_t::width>(delta_phi(s.phi[i], s.phi[j])));
+        int ieta = std::abs(wrap<Puppi::eta_t::width>(s.eta[i] - s.eta[j]));
+        int c = LUT_COSH[std::min(ieta, COSCOSH_LUT_SIZE-1)].to_int() - LUT_COS[iphi].to_int();
+        // 2 * (pt1/4) * (pt2/4) * c = pt1 * pt2 * c / 8, saturated to the unsigned 15 bits of mass_t
+        int64_t m8 = int64_t(s.pt[i]) * s.pt[j] * c;
+        return int(std::max<int64_t>(0, std::min<int64_t>(m8, (1 << mass_t::width) - 1)));
+    }
+
+    // deltaR2_slow, truncated to the 24 bits of dr2_t
+    inline unsigned int delta_r2(const Selected & s, int i, int j)
+    {
+        int dphi = delta_phi(s.phi[i], s.phi[j]);
+        int deta = s.eta[i] - s.eta[j];
+        return unsigned(dphi*dphi + deta*deta) & ((1u << dr2_t::width) - 1);
+    }
+
+    // ------------------------------------------------------------------
+    // Mirror of get_triplet_inputs (same feature order)
+    void triplet_inputs(const Selected & s, int i0, int i1, int i2, w3p_bdt::input_t BDT_inputs[w3p_bdt::n_features])
+    {
+        const int Z0_BITS = Puppi::z0_t::width;
+        int dVz01 = wrap<Z0_BITS>(s.z0[i0] - s.z0[i1]);
+        int dVz02 = wrap<Z0_BITS>(s.z0[i0] - s.z0[i2]);
+        int dVz12 = wrap<Z0_BITS>(s.z0[i1] - s.z0[i2]);
+        unsigned int dr2 = std::min(delta_r2(s, i0, i1), std::min(delta_r2(s, i0, i2), delta_r2(s, i1, i2)));
+
+        BDT_inputs[0]  = s.pt[i2] / 4.;
+        BDT_inputs[1]  = s.pt[i1] / 4.;
+        BDT_inputs[2]  = pair_mass8(s, i0, i1) / 8.;
+        BDT_inputs[3]  = charge(s.id[i0]) + charge(s.id[i1]) + charge(s.id[i2]);
+        BDT_inputs[4]  = s.z0[i0] - s.z0[i2];
+        BDT_inputs[5]  = s.pt[i0] / 4.;
+        BDT_inputs[6]  = (s.pt[i0] + s.pt[i1] + s.pt[i2]) / 4.;
+        BDT_inputs[7]  = pair_mass8(s, i0, i2) / 8.;
+        BDT_inputs[8]  = std::max(dVz01, std::max(dVz02, dVz12));
+        BDT_inputs[9]  = double(dr2);
+        BDT_inputs[10] = s.eta[i2];
+    }
+
+    void event_inputs(const PuppiBlock & block, const uint8_t selected[NPUPPI_SEL],
+                      w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features])
+    {
+        Selected s;
+        for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+        {
+            unsigned int k = selected[i];
+            s.pt[i]  = block.pt[k];
+            s.eta[i] = block.eta[k];
+            s.phi[i] = block.phi[k];
+            s.id[i]  = block.id[k];
+            s.z0[i]  = block.z0[k];
+        }
+
+        for (unsigned int t = 0; t < NTRIPLETS; t++)
+            triplet_inputs(s, TRIPLETS[t][0], TRIPLETS[t][1], TRIPLETS[t][2], BDT_inputs[t]);
+    }
+
+    // ------------------------------------------------------------------
+    // Full chain, same output as ::EventProcessor7f
+    void EventProcessor7f(PuppiBlock & block, w3p_bdt::score_t & max_score)
+    {
+        mask(block);
+
+        uint8_t selected[NPUPPI_SEL];
+        order(block, selected);
+
+        w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
+        event_inputs(block, selected, BDT_inputs);
+
+        for (unsigned int i = 0; i < NTRIPLETS; i++)
+        {
+            w3p_bdt::score_t score;
+            w3p_bdt::bdt.decision_function(BDT_inputs[i], &score);
+            if (i == 0 || score > max_score) max_score = score;
+        }
+    }
+
+} // namespace
@@ -0,0 +1,48 @@
+#ifndef FAST_PATH_H
+#define FAST_PATH_H
+
+#include "../src/event_processor.h"
+#include "puppi_block.h"
+
+#include <cstdint>
+
+// ------------------------------------------------------------------
+// CPU fast path of EventProcessor7f on PuppiBlock
+//
+// Same results as EventProcessor7f, bit by bit, without moving ap_* candidates around:
+//  - mask:     one branchless pass over the int16 columns
+//  - order:    the (pT, index) keys of sorter7f held in a uint32_t, sorted with the
+//              SIMD bitonic sort of simd_sort.h: keys are unique, hence the same permutation
+//  - features: native integer arithmetic with the ap_* wrap/saturation made explicit,
+//              converted to w3p_bdt::input_t only at the end
+// The BDT itself is the firmware w3p_bdt::bdt.
+namespace fast_path {
+
+    // Sort key: same bits as sortkey_t (raw pT above the inverted index) in a native integer
+    inline uint32_t sort_key(int16_t pt, unsigned int idx)
+    {
+        const uint32_t idxMask = (1u << idx_t::width) - 1;
+        return (uint32_t(uint16_t(pt)) << idx_t::width) | (~idx & idxMask);
+    }
+
+    inline unsigned int key_index(uint32_t key)
+    {
+        return ~key & ((1u << idx_t::width) - 1);
+    }
+
+    // Replace masked candidates (same selections as masker) with zeros, in place
+    void mask(PuppiBlock & block);
+
+    // Indices of the NPUPPI_SEL leading candidates, in the order of sorter7f + selector7f
+    void order(const PuppiBlock & block, uint8_t selected[NPUPPI_SEL]);
+
+    // BDT inputs of the NTRIPLETS triplets of get_event_inputs
+    void event_inputs(const PuppiBlock & block, const uint8_t selected[NPUPPI_SEL],
+                      w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features]);
+
+    // Full chain; block is masked in place
+    void EventProcessor7f(PuppiBlock & block, w3p_bdt::score_t & max_score);
+
+} // namespace
+
+#endif
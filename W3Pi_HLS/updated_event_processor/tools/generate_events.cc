@@ -0,0 +1,294 @@
+// ------------------------------------------------------------------
+// Synthetic PU-like event generator writing dump files (header + Puppi::pack words)
+//
+// Usage:
+//   generate_events -o out.dump [-n nevents] [--seed S]
+//                   [--npuppi N | --npuppi-mean MU] [--npuppi-min N] [--npuppi-max N]
+//                   [--pt-min PT] [--pt-mean PT] [--eta-max ETA]
+//                   [--pv-sigma MM] [--z0-sigma MM] [--pid-frac f0,f1,f2,f3,f4,f5,f6,f7]
+//                   [--signal-frac F] [--run N] [--index]
+//
+//  - candidates per event: fixed (--npuppi, e.g. NPUPPI_MAX for worst-case occupancy)
+//    or Poisson(--npuppi-mean) clipped to [--npuppi-min, --npuppi-max]
+//  - pT: pt-min + exponential with mean pt-mean; eta uniform in |eta| < eta-max; phi uniform
+//  - z0: primary vertex ~ Gauss(0, pv-sigma) plus Gauss(0, z0-sigma) per candidate
+//  - PID fractions in Puppi::PID order (H0, Gamma, HMinus, HPlus, EMinus, EPlus, MuMinus, MuPlus)
+//  - with probability signal-frac a W->3pi triplet (massless 3-body phase space, flat in the
+//    Dalitz plane, of a W with a few GeV of pT and a Gaussian rapidity of width 1.5) replaces
+//    three random candidates of the event; the pions out of |eta| < eta-max are not detected
+//    and leave their candidate unchanged
+// The output is fully determined by the seed (for a given standard library implementation).
+#include "../src/data.h"
+#include "dump_reader.h"
+#include "dump_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define MW_PDG 80.377   // m_W from PDG 2022
+#define N_BX 3564       // bunch crossings per orbit
+
+// Generator configuration
+struct GenConfig {
+    size_t nevents = 1000;
+    uint64_t seed = 12345;
+    int npuppi = -1;          // fixed number of candidates, <0 = Poisson
+    double npuppiMean = 60;
+    unsigned int npuppiMin = 0;
+    unsigned int npuppiMax = NPUPPI_MAX;
+    double ptMin = 1.0;       // GeV
+    double ptMean = 3.0;      // GeV, mean of the exponential above ptMin
+    double etaMax = 2.5;
+    double pvSigma = 35.0;    // mm
+    double z0Sigma = 2.0;     // mm
+    std::vector<double> pidFrac = {0.15, 0.20, 0.30, 0.30, 0.01, 0.01, 0.015, 0.015};
+    double signalFrac = 0.0;
+    unsigned int run = 0;
+    bool writeIndex = false;
+};
+
+// Simple massless 4-vector
+struct P4 {
+    double px, py, pz, e;
+};
+
+// Massless candidate from (pt, eta, phi), eta and z0 clipped to the range of eta_t and z0_t
+Puppi makePuppi(double pt, double eta, double phi, unsigned int pid, double z0)
+{
+    const double etaMax = ((1 << (Puppi::eta_t::width-1)) - 1) * Puppi::ETAPHI_LSB;
+    Puppi p;
+    p.hwPt  = Puppi::toHwPt(pt);
+    p.hwEta = Puppi::toHwEta(std::max(-etaMax, std::min(etaMax, eta)));
+    p.hwPhi = Puppi::toHwPhi(phi);
+    p.hwID  = pid;
+    p.hwZ0  = Puppi::toHwZ0(std::max(-255.5, std::min(255.5, z0)));
+    return p;
+}
+
+// Two-body decay of a particle of mass m (at rest) into massless daughters of masses (m1, 0)
+// along a random direction: returns momentum of the massless daughter in the rest frame
+P4 twoBodyMassless(double m, double m1, std::mt19937_64 & rng)
+{
+    std::uniform_real_distribution<double> flat(0., 1.);
+    double p = (m*m - m1*m1) / (2*m);
+    double cost = 2*flat(rng) - 1, sint = std::sqrt(1 - cost*cost);
+    double phi = 2*M_PI*flat(rng);
+    return {p*sint*std::cos(phi), p*sint*std::sin(phi), p*cost, p};
+}
+
+// Boost q by velocity (bx, by, bz)
+P4 boost(const P4 & q, double bx, double by, double bz)
+{
+    double b2 = bx*bx + by*by + bz*bz;
+    if (b2 <= 0) return q;
+    double gamma = 1 / std::sqrt(1 - b2);
+    double bp = bx*q.px + by*q.py + bz*q.pz;
+    double g2 = (gamma - 1) / b2;
+    return {q.px + g2*bp*bx + gamma*bx*q.e,
+            q.py + g2*bp*by + gamma*by*q.e,
+            q.pz + g2*bp*bz + gamma*bz*q.e,
+            gamma*(q.e + bp)};
+}
+
+// W -> 3 massless pions: sequential W -> pi X, X -> pi pi, then boost of the W
+std::vector<P4> generateTriplet(std::mt19937_64 & rng)
+{
+    std::uniform_real_distribution<double> flat(0., 1.);
+    std::normal_distribution<double> gauss(0., 1.);
+
+    // Invariant mass of the pi-pi system: (m12^2, m23^2) uniform in the Dalitz triangle
+    // m12^2 + m23^2 <= mW^2 (accept-reject), X = pi2 pi3. With isotropic two-body decays
+    // this gives the massless 3-body phase space, m_X^2 distributed as (1 - m_X^2/mW^2)
+    const double mW2 = MW_PDG*MW_PDG;
+    double m12sq, m23sq;
+    do {
+        m12sq = mW2 * flat(rng);
+        m23sq = mW2 * flat(rng);
+    } while (m12sq + m23sq > mW2);
+    double mX = std::sqrt(m23sq);
+
+    // W -> pi1 + X, in the W frame
+    P4 pi1 = twoBodyMassless(MW_PDG, mX, rng);
+    double eX = MW_PDG - pi1.e;
+    double bXx = -pi1.px/eX, bXy = -pi1.py/eX, bXz = -pi1.pz/eX;
+
+    // X -> pi2 + pi3, in the X frame, then to the W frame
+    P4 pi2 = twoBodyMassless(mX, 0., rng);
+    P4 pi3 = {-pi2.px, -pi2.py, -pi2.pz, pi2.e};
+    pi2 = boost(pi2, bXx, bXy, bXz);
+    pi3 = boost(pi3, bXx, bXy, bXz);
+
+    // W with a few GeV of pT and a rapidity spread
+    double wpx = 5*gauss(rng), wpy = 5*gauss(rng), wy = 1.5*gauss(rng);
+    double mt = std::sqrt(MW_PDG*MW_PDG + wpx*wpx + wpy*wpy);
+    double wpz = mt*std::sinh(wy), we = mt*std::cosh(wy);
+
+    std::vector<P4> pions;
+    for (const P4 & pi : {pi1, pi2, pi3})
+        pions.push_back(boost(pi, wpx/we, wpy/we, wpz/we));
+    return pions;
+}
+
+// Parse comma-separated list of doubles
+std::vector<double> parseList(const std::string & s)
+{
+    std::vector<double> out;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        out.push_back(std::atof(item.c_str()));
+    return out;
+}
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " -o out.dump [-n nevents] [--seed S] [--npuppi N | --npuppi-mean MU]"
+              << " [--npuppi-min N] [--npuppi-max N] [--pt-min PT] [--pt-mean PT] [--eta-max ETA]"
+              << " [--pv-sigma MM] [--z0-sigma MM] [--pid-frac f0,..,f7] [--signal-frac F] [--run N] [--index]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    GenConfig cfg;
+    std::string outname;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = (i+1 < argc);
+        if      (arg == "-o"            && hasValue) outname        = argv[++i];
+        else if (arg == "-n"            && hasValue) cfg.nevents    = std::atol(argv[++i]);
+        else if (arg == "--seed"        && hasValue) cfg.seed       = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--npuppi"      && hasValue) cfg.npuppi     = std::atoi(argv[++i]);
+        else if (arg == "--npuppi-mean" && hasValue) cfg.npuppiMean = std::atof(argv[++i]);
+        else if (arg == "--npuppi-min"  && hasValue) cfg.npuppiMin  = std::atoi(argv[++i]);
+        else if (arg == "--npuppi-max"  && hasValue) cfg.npuppiMax  = std::atoi(argv[++i]);
+        else if (arg == "--pt-min"      && hasValue) cfg.ptMin      = std::atof(argv[++i]);
+        else if (arg == "--pt-mean"     && hasValue) cfg.ptMean     = std::atof(argv[++i]);
+        else if (arg == "--eta-max"     && hasValue) cfg.etaMax     = std::atof(argv[++i]);
+        else if (arg == "--pv-sigma"    && hasValue) cfg.pvSigma    = std::atof(argv[++i]);
+        else if (arg == "--z0-sigma"    && hasValue) cfg.z0Sigma    = std::atof(argv[++i]);
+        else if (arg == "--pid-frac"    && hasValue) cfg.pidFrac    = parseList(argv[++i]);
+        else if (arg == "--signal-frac" && hasValue) cfg.signalFrac = std::atof(argv[++i]);
+        else if (arg == "--run"         && hasValue) cfg.run        = std::atoi(argv[++i]);
+        else if (arg == "--index") cfg.writeIndex = true;
+        else { usage(argv[0]); return 1; }
+    }
+    if (outname.empty()) { usage(argv[0]); return 1; }
+    if (cfg.pidFrac.size() != 8)
+    {
+        std::cout << "--pid-frac needs 8 fractions" << std::endl;
+        return 1;
+    }
+    // The header stores npuppi on 8 bits
+    if (cfg.npuppiMax > 255 || (cfg.npuppi > 255))
+    {
+        std::cout << "At most 255 candidates per event can be stored" << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(outname, std::ios::out | std::ios::binary);
+    if (!out.good())
+    {
+        std::cout << "Cannot open output file " << outname << std::endl;
+        return 1;
+    }
+
+    std::mt19937_64 rng(cfg.seed);
+    std::uniform_real_distribution<double> flat(0., 1.);
+    std::normal_distribution<double> gauss(0., 1.);
+    std::exponential_distribution<double> expo(1. / cfg.ptMean);
+    std::poisson_distribution<int> poisson(cfg.npuppiMean);
+    std::discrete_distribution<int> pid(cfg.pidFrac.begin(), cfg.pidFrac.end());
+
+    std::vector<uint64_t> words;
+    words.reserve(256);
+    size_t ncand = 0, nsignal = 0, nsignalAccepted = 0;
+    for (size_t ievt = 0; ievt < cfg.nevents; ievt++)
+    {
+        // Number of candidates
+        int n = cfg.npuppi >= 0 ? cfg.npuppi : poisson(rng);
+        n = std::max<int>(cfg.npuppiMin, std::min<int>(cfg.npuppiMax, n));
+
+        // Header: consecutive bunch crossings
+        EventHeader header;
+        header.npuppi = n;
+        header.bx     = ievt % N_BX;
+        header.orbit  = ievt / N_BX;
+        header.run    = cfg.run;
+        header.error  = false;
+        header.valid  = true;
+
+        // PU-like candidates
+        double pv = cfg.pvSigma * gauss(rng);
+        std::vector<Puppi> cands(n);
+        for (int i = 0; i < n; i++)
+        {
+            double pt  = cfg.ptMin + expo(rng);
+            double eta = cfg.etaMax * (2*flat(rng) - 1);
+            double phi = M_PI * (2*flat(rng) - 1);
+            double z0  = pv + cfg.z0Sigma * gauss(rng);
+            cands[i] = makePuppi(pt, eta, phi, pid(rng), z0);
+        }
+
+        // Optional W->3pi triplet at random positions
+        if (n >= 3 && flat(rng) < cfg.signalFrac)
+        {
+            std::vector<P4> pions = generateTriplet(rng);
+            bool plus = flat(rng) < 0.5;
+            std::vector<int> slots(n);
+            for (int i = 0; i < n; i++) slots[i] = i;
+            std::shuffle(slots.begin(), slots.end(), rng);
+            unsigned int ndetected = 0;
+            for (unsigned int k = 0; k < 3; k++)
+            {
+                const P4 & q = pions[k];
+                double pt = std::hypot(q.px, q.py);
+                double eta = std::asinh(q.pz / pt);
+                double phi = std::atan2(q.py, q.px);
+                double z0 = pv + cfg.z0Sigma * gauss(rng);
+                if (!(std::abs(eta) < cfg.etaMax)) continue; // out of the acceptance
+                bool positive = (k < 2) == plus; // total charge +-1
+                unsigned int id = positive ? Puppi::HPlus : Puppi::HMinus;
+                cands[slots[k]] = makePuppi(pt, eta, phi, id, z0);
+                ndetected++;
+            }
+            nsignal++;
+            if (ndetected == 3) nsignalAccepted++;
+        }
+
+        // Write event
+        words.clear();
+        words.push_back(header.encode());
+        for (const Puppi & p : cands)
+            words.push_back(p.pack());
+        out.write(reinterpret_cast<const char *>(words.data()), words.size()*sizeof(uint64_t));
+        ncand += n;
+    }
+    out.close();
+    if (!out.good())
+    {
+        std::cout << "Error writing " << outname << std::endl;
+        return 1;
+    }
+
+    std::cout << "*** " << outname << ": " << cfg.nevents << " events, " << ncand << " candidates, "
+              << nsignal << " with W->3pi triplet (" << nsignalAccepted << " with the 3 pions in |eta| < "
+              << cfg.etaMax << ", seed " << cfg.seed << ")" << std::endl;
+
+    if (cfg.writeIndex)
+    {
+        DumpReader reader(outname, false);
+        dump_index::write(dump_index::indexName(outname), reader.index(), reader.words(), reader.nwords());
+    }
+
+    return 0;
+}
@@ -0,0 +1,93 @@
+// ------------------------------------------------------------------
+// Generator of the cos/cosh ROM tables of get_cos_phi/get_cosh_eta/get_coshw_eta (src/coscosh_lut.h)
+//
+// Usage:
+//   make_coscosh_lut > src/coscosh_lut.h
+//   make_coscosh_lut --check
+//
+// The tables are filled by _lut_cos_init/_lut_cosh_init/_lut_coshw_init (src/event_processor.cc),
+// the definition of the LUT contents, and written as the constant arrays LUT_COS/LUT_COSH/LUT_COSHW.
+// With --check the arrays of the compiled-in coscosh_lut.h are compared to freshly
+// filled tables instead, and LUT_COSH to LUT_COSHW saturated to cosh_t (get_pair_matrix
+// relies on it): returns 1 at the first mismatching entry.
+#include "../src/event_processor.h"
+#include "../src/coscosh_lut.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+template<typename T>
+void write_table(const char * type, const char * name, const T table[COSCOSH_LUT_SIZE])
+{
+    std::cout << "static const " << type << " " << name << "[COSCOSH_LUT_SIZE] = {";
+    for (int i = 0; i < COSCOSH_LUT_SIZE; i++)
+    {
+        if (i % 16 == 0) std::cout << "\n   ";
+        std::cout << " " << table[i].to_int() << (i < COSCOSH_LUT_SIZE-1 ? "," : "");
+    }
+    std::cout << "\n};\n";
+}
+
+template<typename T>
+bool check_table(const char * name, const T table[COSCOSH_LUT_SIZE], const T rom[COSCOSH_LUT_SIZE])
+{
+    for (int i = 0; i < COSCOSH_LUT_SIZE; i++)
+    {
+        if (table[i] != rom[i])
+        {
+            std::cout << " FAIL " << name << "[" << i << "]: " << rom[i].to_int() << " instead of " << table[i].to_int() << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+
+    bool check = argc > 1 && !std::strcmp(argv[1], "--check");
+    if (argc > 2 || (argc > 1 && !check))
+    {
+        std::cout << "Usage: " << argv[0] << " [--check]" << std::endl;
+        return 1;
+    }
+
+    cos_t table_cos[COSCOSH_LUT_SIZE];
+    cosh_t table_cosh[COSCOSH_LUT_SIZE];
+    coshw_t table_coshw[COSCOSH_LUT_SIZE];
+    _lut_cos_init(table_cos);
+    _lut_cosh_init(table_cosh);
+    _lut_coshw_init(table_coshw);
+
+    if (check)
+    {
+        bool ok = check_table("LUT_COS", table_cos, LUT_COS) && check_table("LUT_COSH", table_cosh, LUT_COSH)
+               && check_table("LUT_COSHW", table_coshw, LUT_COSHW);
+        for (int i = 0; ok && i < COSCOSH_LUT_SIZE; i++)
+        {
+            int saturated = std::min(LUT_COSHW[i].to_int(), COSCOSH_LUT_SIZE-1);
+            if (LUT_COSH[i].to_int() != saturated)
+            {
+                std::cout << " FAIL LUT_COSH[" << i << "]: " << LUT_COSH[i].to_int() << " instead of LUT_COSHW saturated " << saturated << std::endl;
+                ok = false;
+            }
+        }
+        std::cout << (ok ? "*** coscosh_lut.h up to date" : "*** coscosh_lut.h out of date, regenerate it") << std::endl;
+        return ok ? 0 : 1;
+    }
+
+    std::cout << "#ifndef COSCOSH_LUT_H\n"
+                 "#define COSCOSH_LUT_H\n\n"
+                 "#include \"data.h\"\n\n"
+                 "// ------------------------------------------------------------------\n"
+                 "// cos and cosh ROMs of get_cos_phi/get_cosh_eta/get_coshw_eta, indexed by |dphi| and |deta|\n"
+                 "// in units of Puppi::ETAPHI_LSB, values times COSCOSH_LSB (_lut_cos_init/_lut_cosh_init/_lut_coshw_init)\n"
+                 "// Generated by tools/make_coscosh_lut.cc: do not edit\n";
+    write_table("cos_t  ", "LUT_COS  ", table_cos);
+    std::cout << "\n";
+    write_table("cosh_t ", "LUT_COSH ", table_cosh);
+    std::cout << "\n";
+    write_table("coshw_t", "LUT_COSHW", table_coshw);
+    std::cout << "\n#endif\n";
+    return 0;
+}
@@ -0,0 +1,68 @@
+// ------------------------------------------------------------------
+// Build the sidecar .idx event index of one or more dump files
+//
+// Usage:
+//   make_index [-s nshards] [--orbit N] [--bx N] file1.dump [file2.dump ...]
+//
+// With -s the balanced shards (by candidate count) are printed, with --orbit/--bx
+// the number of the matching events.
+#include "dump_reader.h"
+#include "dump_index.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-s nshards] [--orbit N] [--bx N] file1.dump [file2.dump ...]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    unsigned int nshards = 0;
+    long orbit = -1, bx = -1;
+    std::vector<std::string> fnames;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!std::strcmp(argv[i], "-s")      && i+1 < argc) nshards = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--orbit") && i+1 < argc) orbit   = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--bx")    && i+1 < argc) bx      = std::atol(argv[++i]);
+        else if (argv[i][0] == '-') { usage(argv[0]); return 1; }
+        else fnames.push_back(argv[i]);
+    }
+    if (fnames.empty()) { usage(argv[0]); return 1; }
+
+    for (const std::string & fname : fnames)
+    {
+        // Always re-scan the dump when building the index
+        DumpReader reader(fname, false);
+        std::string idxName = dump_index::indexName(fname);
+        dump_index::write(idxName, reader.index(), reader.words(), reader.nwords());
+
+        size_t ncand = 0, nerror = 0;
+        for (const EventInfo & info : reader.index())
+        {
+            ncand += info.npuppi;
+            nerror += info.error;
+        }
+        std::cout << "*** " << fname << " -> " << idxName << ": " << reader.size() << " events, "
+                  << ncand << " candidates, " << nerror << " with error bit" << std::endl;
+
+        if (nshards)
+        {
+            auto shards = dump_index::balancedShards(reader.index(), nshards);
+            for (unsigned int is = 0; is < shards.size(); is++)
+                std::cout << " - shard " << is << ": events [" << shards[is].first << ", " << shards[is].second << ")" << std::endl;
+        }
+        if (orbit >= 0)
+            std::cout << " - orbit " << orbit << ": " << dump_index::selectOrbit(reader.index(), orbit).size() << " events" << std::endl;
+        if (bx >= 0)
+            std::cout << " - bx " << bx << ": " << dump_index::selectBx(reader.index(), bx).size() << " events" << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,533 @@
+// ------------------------------------------------------------------
+// Fixed-point precision sweep of the triplet features and BDT of EventProcessor7f
+//
+// Usage:
+//   precision_sweep [-j nthreads] [-n maxevents] [--cut X | --rate R] [--max-loss L] [--max-rate-increase F]
+//                   [--bdt conifer.json] -s signal.dump [...] [-b background.dump [...]]
+//
+// The selected candidates of each event come from the C model (masker, slimmer, sorter7f,
+// selector7f), whose precision is not swept. The pair masses, the BDT inputs and the BDT are
+// then recomputed for every Precision setting of SweepGrid (below, edit and rebuild to change
+// it): COSCOSH_LSB and the widths of cos_t, cosh_t, mass_t, w3p_bdt::input_t (and threshold_t)
+// and w3p_bdt::score_t are template arguments, the arithmetic is that of get_pair_matrix and
+// gather_triplet_inputs, the BDT is the conifer emulation of the reference with the balanced
+// sum of the firmware. The first setting is the firmware one: its inputs and scores are
+// checked to be bit-identical to get_event_inputs/get_event_scores.
+//
+// The float reference is the same model in double precision (exact cos/cosh, no saturation,
+// double BDT thresholds and leaves). An event passes if its max_score is above the cut: --cut,
+// or by default the cut at which the float reference accepts a fraction --rate (1%) of the
+// background events (0 without background). Per setting are reported: signal efficiency and
+// background acceptance, signal events lost and gained and background flips with respect to
+// the float reference, mean and max |max_score - float max_score|, fractions of saturated pair
+// masses and BDT inputs, and a first-order LUT/DSP estimate (estimate_cost). A setting is ok if
+// it loses at most a fraction --max-loss (0.02) of the signal efficiency and accepts at most
+// 1 + --max-rate-increase (1.1) times the background of the float reference; the narrowest ok
+// width of each type is summarized at the end, as a Precision combination to add to SweepGrid
+// and check.
+// Must run from a directory containing conifer_binary_featV4_finalFit_v5.json (or use --bdt).
+#include "../src/event_processor.h"
+#include "../src/coscosh_lut.h"
+#include "../BDT/conifer.h"
+#include "dump_reader.h"
+#include "work_stealing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#define CHUNK_SIZE 64 // events per task
+#define NPAIRS (NPUPPI_SEL*(NPUPPI_SEL-1)/2)
+
+// ------------------------------------------------------------------
+// One precision setting:
+//  - COSCOSH_LSB = 2^LSB_BITS, cos_t of LSB_BITS+2 bits (cos in [-2, 2) as in the firmware)
+//  - cosh_t of COSH_I+LSB_BITS bits (saturates at 2^COSH_I, i.e. |deta| = acosh(2^COSH_I))
+//  - mass_t = ap_ufixed<MASS_W, MASS_I, AP_RND, AP_SAT>
+//  - input_t = threshold_t = ap_fixed<IN_W, IN_I, AP_RND_CONV, AP_SAT>
+//  - score_t = ap_fixed<SCORE_W, SCORE_I, AP_RND_CONV, AP_SAT>
+// cos and cosh are held as fixed point values (LUT integers / COSCOSH_LSB) and the pair mass is
+// rescaled to the firmware COSCOSH_LSB, so that the BDT features keep their definition
+template<int LSB_BITS, int COSH_I, int MASS_W, int MASS_I, int IN_W, int IN_I, int SCORE_W, int SCORE_I>
+struct Precision {
+    static constexpr int NPARAMS = 8;
+    static constexpr int LSB = 1 << LSB_BITS;
+    static constexpr int COS_W = LSB_BITS + 2;
+    static constexpr int COSH_W = COSH_I + LSB_BITS;
+    typedef arith::ap_fixed<COS_W, 2> cos_t;
+    typedef arith::ap_ufixed<COSH_W, COSH_I> cosh_t;
+    typedef arith::ap_ufixed<MASS_W, MASS_I, AP_RND, AP_SAT> mass_t;
+    typedef arith::ap_fixed<IN_W, IN_I, AP_RND_CONV, AP_SAT> input_t;
+    typedef arith::ap_fixed<SCORE_W, SCORE_I, AP_RND_CONV, AP_SAT> score_t;
+
+    static std::vector<int> params() { return {LSB_BITS, COSH_I, MASS_W, MASS_I, IN_W, IN_I, SCORE_W, SCORE_I}; }
+
+    // cos and cosh ROMs, filled as _lut_cos_init/_lut_cosh_init
+    struct Luts {
+        cos_t cos[COSCOSH_LUT_SIZE];
+        cosh_t cosh[COSCOSH_LUT_SIZE];
+
+        Luts() {
+            for (int i = 0; i < COSCOSH_LUT_SIZE; ++i)
+            {
+                float alpha = Puppi::ETAPHI_LSB * i;
+                int ic = std::cos(alpha) * LSB;
+                int ich = std::cosh(alpha) * LSB;
+                ic = std::max(-(1 << (COS_W-1)) + 1, std::min((1 << (COS_W-1)) - 1, ic));
+                ich = std::min((1 << COSH_W) - 1, ich);
+                cos[i] = cos_t(double(ic) / LSB);
+                cosh[i] = cosh_t(double(ich) / LSB);
+            }
+        }
+    };
+    static const Luts & luts() { static const Luts l; return l; }
+};
+
+// Firmware setting, the first of the sweep
+typedef Precision<8, 2, 15, 12, 19, 8, 11, 4> Firmware;
+static_assert(Firmware::LSB == COSCOSH_LSB, "Firmware setting must match COSCOSH_LSB");
+static_assert(Firmware::COS_W == cos_t::width && Firmware::COSH_W == cosh_t::width, "Firmware setting must match cos_t/cosh_t");
+static_assert(std::is_same<Firmware::mass_t, mass_t>::value, "Firmware setting must match mass_t");
+static_assert(std::is_same<Firmware::input_t, w3p_bdt::input_t>::value, "Firmware setting must match w3p_bdt::input_t");
+static_assert(std::is_same<Firmware::input_t, w3p_bdt::threshold_t>::value, "Firmware setting must match w3p_bdt::threshold_t");
+static_assert(std::is_same<Firmware::score_t, w3p_bdt::score_t>::value, "Firmware setting must match w3p_bdt::score_t");
+
+template<class... P> struct Grid {};
+
+// Widths scanned one type at a time around the firmware setting
+typedef Grid<
+    Firmware,
+    // COSCOSH_LSB (cos_t/cosh_t widths follow)
+    Precision< 4, 2, 15, 12, 19, 8, 11, 4>, Precision< 5, 2, 15, 12, 19, 8, 11, 4>, Precision< 6, 2, 15, 12, 19, 8, 11, 4>,
+    Precision< 7, 2, 15, 12, 19, 8, 11, 4>, Precision< 9, 2, 15, 12, 19, 8, 11, 4>, Precision<10, 2, 15, 12, 19, 8, 11, 4>,
+    // cosh_t saturation: cosh < 2, 8, 16, 64
+    Precision< 8, 1, 15, 12, 19, 8, 11, 4>, Precision< 8, 3, 15, 12, 19, 8, 11, 4>, Precision< 8, 4, 15, 12, 19, 8, 11, 4>,
+    Precision< 8, 6, 15, 12, 19, 8, 11, 4>,
+    // mass_t fractional bits, then integer bits
+    Precision< 8, 2, 12, 12, 19, 8, 11, 4>, Precision< 8, 2, 13, 12, 19, 8, 11, 4>, Precision< 8, 2, 14, 12, 19, 8, 11, 4>,
+    Precision< 8, 2, 17, 12, 19, 8, 11, 4>,
+    Precision< 8, 2, 11,  8, 19, 8, 11, 4>, Precision< 8, 2, 13, 10, 19, 8, 11, 4>, Precision< 8, 2, 17, 14, 19, 8, 11, 4>,
+    Precision< 8, 2, 19, 16, 19, 8, 11, 4>,
+    // input_t fractional bits, then integer bits
+    Precision< 8, 2, 15, 12, 11, 8, 11, 4>, Precision< 8, 2, 15, 12, 13, 8, 11, 4>, Precision< 8, 2, 15, 12, 15, 8, 11, 4>,
+    Precision< 8, 2, 15, 12, 17, 8, 11, 4>, Precision< 8, 2, 15, 12, 21, 8, 11, 4>,
+    Precision< 8, 2, 15, 12, 18, 7, 11, 4>, Precision< 8, 2, 15, 12, 21, 10, 11, 4>, Precision< 8, 2, 15, 12, 23, 12, 11, 4>,
+    Precision< 8, 2, 15, 12, 25, 14, 11, 4>,
+    // score_t fractional bits, then integer bits
+    Precision< 8, 2, 15, 12, 19, 8,  7, 4>, Precision< 8, 2, 15, 12, 19, 8,  8, 4>, Precision< 8, 2, 15, 12, 19, 8,  9, 4>,
+    Precision< 8, 2, 15, 12, 19, 8, 10, 4>, Precision< 8, 2, 15, 12, 19, 8, 13, 4>, Precision< 8, 2, 15, 12, 19, 8, 15, 4>,
+    Precision< 8, 2, 15, 12, 19, 8,  9, 2>, Precision< 8, 2, 15, 12, 19, 8, 10, 3>, Precision< 8, 2, 15, 12, 19, 8, 12, 5>
+> SweepGrid;
+
+// Parameters of each swept type, the first one ordering the settings by width (LSB_BITS,
+// COSH_I or W), for the narrowest ok width summary
+struct TypeGroup { const char * name; int first, size; };
+static const TypeGroup TYPE_GROUPS[] = {{"COSCOSH_LSB", 0, 1}, {"cosh_t", 1, 1}, {"mass_t", 2, 2}, {"input_t", 4, 2}, {"score_t", 6, 2}};
+
+// ------------------------------------------------------------------
+// Per event inputs of the sweep
+
+// Width-independent part of the BDT inputs (as double, exact) and the pair angles
+struct EventData {
+    bool signal;
+    double features[NTRIPLETS][w3p_bdt::n_features]; // [2] and [7] (pair masses) left to the setting
+    int dphi[NPUPPI_SEL][NPUPPI_SEL], deta[NPUPPI_SEL][NPUPPI_SEL];
+    Puppi::pt_t pt[NPUPPI_SEL];
+    double scoreFloat[NTRIPLETS], maxFloat;
+    double inputsFW[NTRIPLETS][w3p_bdt::n_features], scoresFW[NTRIPLETS];
+};
+
+// Float pair mass: 2 pT1 pT2 (cosh - cos) in units of the firmware COSCOSH_LSB
+inline double pair_mass_float(const EventData & ev, int i, int j)
+{
+    double c  = std::cos(ev.dphi[i][j] * double(Puppi::ETAPHI_LSB));
+    double ch = std::cosh(ev.deta[i][j] * double(Puppi::ETAPHI_LSB));
+    return 2 * ev.pt[i].to_double() * ev.pt[j].to_double() * (ch - c) * COSCOSH_LSB;
+}
+
+// Selected candidates, BDT inputs and scores of the C model, the exact features and the float reference
+template<class BDT>
+void prepare_event(const Puppi input[NPUPPI_MAX], bool signal, const BDT & bdtFloat, EventData & ev)
+{
+    ap_uint<NPUPPI_MAX> masked;
+    masker(input, masked);
+    Puppi slimmed[NPUPPI_MAX];
+    slimmer(input, masked, slimmed);
+    sortkey_t sorted[NPUPPI_MAX];
+    sorter7f(slimmed, sorted);
+    Puppi selected[NPUPPI_SEL];
+    selector7f(slimmed, sorted, selected);
+
+    w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
+    w3p_bdt::score_t BDT_scores[NTRIPLETS];
+    get_event_inputs(selected, BDT_inputs);
+    get_event_scores(BDT_inputs, BDT_scores);
+
+    PuppiPair pairs[NPUPPI_SEL][NPUPPI_SEL];
+    get_pair_matrix(selected, pairs);
+
+    ev.signal = signal;
+    for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+    {
+        ev.pt[i] = selected[i].hwPt;
+        for (unsigned int j = 0; j < NPUPPI_SEL; j++)
+        {
+            ev.dphi[i][j] = pairs[i][j].dphi.to_int();
+            ev.deta[i][j] = pairs[i][j].deta.to_int();
+        }
+    }
+
+    ev.maxFloat = 0;
+    for (unsigned int t = 0; t < NTRIPLETS; t++)
+    {
+        int i0 = TRIPLETS[t][0], i1 = TRIPLETS[t][1], i2 = TRIPLETS[t][2];
+        const Puppi & p0 = selected[i0], & p1 = selected[i1], & p2 = selected[i2];
+
+        // as gather_triplet_inputs
+        Puppi::z0_t dVz_01 = pairs[i0][i1].dz, dVz_02 = pairs[i0][i2].dz, dVz_12 = pairs[i1][i2].dz;
+        dr2_t dr2_01 = pairs[i0][i1].dr2, dr2_02 = pairs[i0][i2].dr2, dr2_12 = pairs[i1][i2].dr2;
+        double * f = ev.features[t];
+        f[0]  = p2.hwPt.to_double();
+        f[1]  = p1.hwPt.to_double();
+        f[2]  = pair_mass_float(ev, i0, i1);
+        f[3]  = p0.charge() + p1.charge() + p2.charge();
+        f[4]  = pairs[i0][i2].dz.to_int();
+        f[5]  = p0.hwPt.to_double();
+        f[6]  = f[5] + f[1] + f[0];
+        f[7]  = pair_mass_float(ev, i0, i2);
+        f[8]  = std::max(dVz_01, std::max(dVz_02, dVz_12)).to_int();
+        f[9]  = std::min(dr2_01, std::min(dr2_02, dr2_12)).to_double();
+        f[10] = p2.hwEta.to_int();
+
+        std::vector<double> x(f, f + w3p_bdt::n_features);
+        ev.scoreFloat[t] = bdtFloat.decision_function(x).at(0);
+        if (t == 0 || ev.scoreFloat[t] > ev.maxFloat) ev.maxFloat = ev.scoreFloat[t];
+
+        for (unsigned int k = 0; k < w3p_bdt::n_features; k++)
+            ev.inputsFW[t][k] = BDT_inputs[t][k].to_double();
+        ev.scoresFW[t] = BDT_scores[t].to_double();
+    }
+}
+
+// ------------------------------------------------------------------
+// Results of one setting
+struct SweepResult {
+    std::string name;
+    std::vector<int> params;
+    unsigned long nsig = 0, nbkg = 0, passSig = 0, passBkg = 0;
+    unsigned long lost = 0, gained = 0, bkgFlips = 0;
+    double sumDiff = 0, maxDiff = 0;
+    unsigned long npairs = 0, massSat = 0, ninputs = 0, inputSat = 0;
+    unsigned long fwMismatch = 0; // events differing from the C model (firmware setting only)
+    int lut = 0, dsp = 0;
+    bool ok = false;
+
+    void add(const SweepResult & o) {
+        nsig += o.nsig; nbkg += o.nbkg; passSig += o.passSig; passBkg += o.passBkg;
+        lost += o.lost; gained += o.gained; bkgFlips += o.bkgFlips;
+        sumDiff += o.sumDiff; maxDiff = std::max(maxDiff, o.maxDiff);
+        npairs += o.npairs; massSat += o.massSat; ninputs += o.ninputs; inputSat += o.inputSat;
+        fwMismatch += o.fwMismatch;
+    }
+};
+
+// DSP48E2 count of an unsigned a x b multiplier (26 x 17 unsigned bits per DSP)
+inline int dsp_tiles(int a, int b)
+{
+    auto ceildiv = [](int x, int y) { return (x + y - 1) / y; };
+    return std::min(ceildiv(a, 26) * ceildiv(b, 17), ceildiv(b, 26) * ceildiv(a, 17));
+}
+
+// First-order resource estimate of the pair masses and of the BDT, to rank the settings
+// (not a substitute for csynth):
+//  - per pair: cos and cosh LUTRAM ROMs of COSCOSH_LUT_SIZE x width (64 x 1 per LUT, one copy
+//    per read port), the cosh - cos subtraction, pT1 x pT2 and x (cosh - cos) on DSPs, the
+//    rounding to mass_t
+//  - per triplet: the rounding of the 2 masses to input_t, and per tree the comparisons
+//    with constant thresholds (W/2 LUTs each), the 8-leaf score mux (2 LUTs per bit) and
+//    the score sum; the max of the triplet scores
+template<class P>
+void estimate_cost(int & lut, int & dsp)
+{
+    const int ptW = Puppi::pt_t::width;
+    const int diffW = std::max(P::COS_W, P::COSH_W) + 1;
+    const int massW = P::mass_t::width, inW = P::input_t::width, scoreW = P::score_t::width;
+    const int nodes = (1 << w3p_bdt::max_depth) - 1;
+
+    int pairLut = COSCOSH_LUT_SIZE / 64 * (P::COS_W + P::COSH_W) + diffW + massW;
+    int pairDsp = dsp_tiles(ptW, ptW) + dsp_tiles(2*ptW, diffW);
+    int tripletLut = 2 * inW + w3p_bdt::n_trees * (nodes * ((inW + 1) / 2) + 2 * scoreW + scoreW);
+
+    lut = NPAIRS * pairLut + NTRIPLETS * tripletLut + (NTRIPLETS - 1) * 2 * scoreW;
+    dsp = NPAIRS * pairDsp;
+}
+
+template<class P>
+std::string setting_name()
+{
+    const std::vector<int> p = P::params();
+    std::ostringstream os;
+    os << "LSB " << std::setw(4) << P::LSB << " cos " << std::setw(2) << P::COS_W << " cosh " << std::setw(2) << P::COSH_W
+       << " mass <" << std::setw(2) << p[2] << "," << std::setw(2) << p[3] << ">"
+       << " in <" << std::setw(2) << p[4] << "," << std::setw(2) << p[5] << ">"
+       << " score <" << std::setw(2) << p[6] << "," << p[7] << ">";
+    return os.str();
+}
+
+// Pair mass of the setting, as get_pair_matrix
+template<class P>
+typename P::mass_t pair_mass(const EventData & ev, int i, int j, SweepResult & res)
+{
+    typedef typename P::mass_t mass_t;
+    static const double massMax = std::ldexp(1., mass_t::iwidth) - std::ldexp(1., mass_t::iwidth - mass_t::width);
+
+    const typename P::Luts & luts = P::luts();
+    int iphi = std::abs(ev.dphi[i][j]);
+    int ieta = std::min(std::abs(ev.deta[i][j]), COSCOSH_LUT_SIZE-1);
+    double diff = luts.cosh[ieta].to_double() - luts.cos[iphi].to_double();
+    double exact = 2 * ev.pt[i].to_double() * ev.pt[j].to_double() * diff * COSCOSH_LSB;
+
+    res.npairs++;
+    if (exact > massMax) res.massSat++;
+    return mass_t(2 * ev.pt[i] * ev.pt[j] * (luts.cosh[ieta] - luts.cos[iphi]) * COSCOSH_LSB);
+}
+
+// Run one setting over the events of one chunk
+template<class P, class BDT>
+void run_chunk(const std::vector<EventData> & events, size_t first, size_t last, const BDT & bdt, double cut,
+               bool checkFW, SweepResult & res)
+{
+    typedef typename P::input_t input_t;
+    static const double inputMax = std::ldexp(1., input_t::iwidth - 1);
+
+    for (size_t iev = first; iev < last; iev++)
+    {
+        const EventData & ev = events[iev];
+        double maxScore = 0;
+        bool sameFW = true;
+        for (unsigned int t = 0; t < NTRIPLETS; t++)
+        {
+            int i0 = TRIPLETS[t][0], i1 = TRIPLETS[t][1], i2 = TRIPLETS[t][2];
+            std::vector<input_t> x(w3p_bdt::n_features);
+            for (unsigned int k = 0; k < w3p_bdt::n_features; k++)
+            {
+                double value;
+                if      (k == 2) value = pair_mass<P>(ev, i0, i1, res).to_double();
+                else if (k == 7) value = pair_mass<P>(ev, i0, i2, res).to_double();
+                else             value = ev.features[t][k];
+                x[k] = value;
+                res.ninputs++;
+                if (value >= inputMax || value < -inputMax) res.inputSat++;
+                if (checkFW && x[k].to_double() != ev.inputsFW[t][k]) sameFW = false;
+            }
+            double score = bdt.decision_function(x).at(0).to_double();
+            if (checkFW && score != ev.scoresFW[t]) sameFW = false;
+            if (t == 0 || score > maxScore) maxScore = score;
+        }
+        if (!sameFW) res.fwMismatch++;
+
+        bool pass = maxScore > cut, passFloat = ev.maxFloat > cut;
+        double d = std::abs(maxScore - ev.maxFloat);
+        res.sumDiff += d;
+        res.maxDiff = std::max(res.maxDiff, d);
+        if (ev.signal)
+        {
+            res.nsig++;
+            res.passSig += pass;
+            res.lost += passFloat && !pass;
+            res.gained += pass && !passFloat;
+        }
+        else
+        {
+            res.nbkg++;
+            res.passBkg += pass;
+            res.bkgFlips += pass != passFloat;
+        }
+    }
+}
+
+template<class P>
+SweepResult run_setting(const std::vector<EventData> & events, unsigned int nthreads, const std::string & bdtFile,
+                        double cut, bool checkFW)
+{
+    // Reference BDT with the types of the setting and the balanced sum of the firmware
+    const conifer::BDT<typename P::input_t, typename P::score_t, true> bdt(bdtFile);
+
+    size_t nchunks = (events.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    std::vector<SweepResult> chunks(nchunks);
+    work_stealing::parallel_for(nchunks, nthreads, [&](size_t ichunk, unsigned int) {
+        run_chunk<P>(events, ichunk * CHUNK_SIZE, std::min(events.size(), (ichunk + 1) * CHUNK_SIZE), bdt, cut, checkFW, chunks[ichunk]);
+    });
+
+    SweepResult res;
+    for (const SweepResult & c : chunks) res.add(c);
+    res.name = setting_name<P>();
+    res.params = P::params();
+    estimate_cost<P>(res.lut, res.dsp);
+    return res;
+}
+
+template<class... P>
+std::vector<SweepResult> run_grid(Grid<P...>, const std::vector<EventData> & events, unsigned int nthreads,
+                                  const std::string & bdtFile, double cut)
+{
+    std::vector<SweepResult> results;
+    int dummy[] = {(results.push_back(run_setting<P>(events, nthreads, bdtFile, cut, results.empty())), 0)...};
+    (void)dummy;
+    return results;
+}
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-j nthreads] [-n maxevents] [--cut X | --rate R] [--max-loss L] [--max-rate-increase F]"
+              << " [--bdt conifer.json] -s signal.dump [...] [-b background.dump [...]]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    unsigned int nthreads = 0; // 0 = all available cores
+    size_t maxevents = 0;      // 0 = all events, per file
+    double cut = 0, rate = 0.01, maxLoss = 0.02, maxRateIncrease = 0.1;
+    bool fixedCut = false, isSignal = true;
+    std::string bdtFile = "conifer_binary_featV4_finalFit_v5.json";
+    std::vector<std::pair<std::string, bool>> fnames;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!std::strcmp(argv[i], "-j")    && i+1 < argc) nthreads  = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-n")    && i+1 < argc) maxevents = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--cut") && i+1 < argc) { cut = std::atof(argv[++i]); fixedCut = true; }
+        else if (!std::strcmp(argv[i], "--rate") && i+1 < argc) rate = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--max-loss") && i+1 < argc) maxLoss = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--max-rate-increase") && i+1 < argc) maxRateIncrease = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--bdt") && i+1 < argc) bdtFile = argv[++i];
+        else if (!std::strcmp(argv[i], "-s")) isSignal = true;
+        else if (!std::strcmp(argv[i], "-b")) isSignal = false;
+        else if (argv[i][0] == '-') { usage(argv[0]); return 1; }
+        else fnames.push_back({argv[i], isSignal});
+    }
+    if (fnames.empty()) { usage(argv[0]); return 1; }
+    if (!std::ifstream(bdtFile).good())
+    {
+        std::cout << "Cannot open BDT file " << bdtFile << std::endl;
+        return 1;
+    }
+
+    // C model and float reference of all events (same event selection as the testbench)
+    const conifer::BDT<double, double, true> bdtFloat(bdtFile);
+    std::vector<EventData> events;
+    for (const auto & f : fnames)
+    {
+        DumpReader reader(f.first);
+        size_t nevents = maxevents ? std::min(maxevents, reader.size()) : reader.size();
+        size_t first = events.size();
+        events.resize(first + nevents);
+        std::vector<char> keep(nevents, 0);
+        work_stealing::parallel_for((nevents + CHUNK_SIZE - 1) / CHUNK_SIZE, nthreads, [&](size_t ichunk, unsigned int) {
+            Puppi inputs[NPUPPI_MAX];
+            for (size_t ievt = ichunk * CHUNK_SIZE; ievt < std::min(nevents, (ichunk + 1) * CHUNK_SIZE); ievt++)
+            {
+                PuppiSpan span = reader.event(ievt);
+                if (span.size < 3 || span.size > NPUPPI_MAX) continue;
+                for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+                {
+                    if (i < span.size) inputs[i].unpack(span[i]);
+                    else inputs[i].clear();
+                }
+                prepare_event(inputs, f.second, bdtFloat, events[first + ievt]);
+                keep[ievt] = 1;
+            }
+        });
+        size_t nkept = first;
+        for (size_t ievt = 0; ievt < nevents; ievt++)
+            if (keep[ievt]) events[nkept++] = events[first + ievt];
+        events.resize(nkept);
+        std::cout << "*** " << f.first << " (" << (f.second ? "signal" : "background") << "): "
+                  << nkept - first << " / " << reader.size() << " events" << std::endl;
+    }
+
+    // Cut: fraction rate of the background accepted by the float reference, halfway between
+    // two distinct scores (the BDT scores take few distinct values)
+    std::vector<double> bkgScores;
+    for (const EventData & ev : events)
+        if (!ev.signal) bkgScores.push_back(ev.maxFloat);
+    if (!fixedCut && !bkgScores.empty())
+    {
+        std::sort(bkgScores.begin(), bkgScores.end(), std::greater<double>());
+        size_t k = std::min(bkgScores.size() - 1, size_t(rate * bkgScores.size()));
+        while (k > 0 && bkgScores[k-1] == bkgScores[k]) k--;
+        cut = k > 0 ? (bkgScores[k-1] + bkgScores[k]) / 2 : bkgScores[0];
+    }
+    unsigned long nsig = 0, passSig = 0, passBkg = 0;
+    for (const EventData & ev : events)
+    {
+        if (ev.signal) { nsig++; passSig += ev.maxFloat > cut; }
+        else passBkg += ev.maxFloat > cut;
+    }
+    double effFloat = nsig ? double(passSig) / nsig : 0;
+    double accFloat = bkgScores.empty() ? 0 : double(passBkg) / bkgScores.size();
+    std::cout << "*** max_score > " << cut << ": float reference signal efficiency " << effFloat
+              << ", background acceptance " << accFloat << std::endl;
+
+    // Sweep
+    std::vector<SweepResult> results = run_grid(SweepGrid(), events, nthreads, bdtFile, cut);
+
+    std::cout << std::endl << std::left << std::setw(64) << "setting" << std::right
+              << std::setw(8) << "eff_sig" << std::setw(8) << "acc_bkg" << std::setw(6) << "lost" << std::setw(7) << "gained"
+              << std::setw(8) << "bkgflip" << std::setw(10) << "mean|ds|" << std::setw(9) << "max|ds|"
+              << std::setw(8) << "msat%" << std::setw(8) << "isat%"
+              << std::setw(7) << "LUT" << std::setw(5) << "DSP" << "  ok" << std::endl;
+    for (SweepResult & r : results)
+    {
+        double eff = r.nsig ? double(r.passSig) / r.nsig : 0;
+        double acc = r.nbkg ? double(r.passBkg) / r.nbkg : 0;
+        r.ok = eff >= effFloat * (1 - maxLoss) && (!r.nbkg || acc <= accFloat * (1 + maxRateIncrease));
+        size_t nev = r.nsig + r.nbkg;
+        std::cout << std::left << std::setw(64) << r.name << std::right << std::fixed
+                  << std::setprecision(4) << std::setw(8) << eff << std::setw(8) << acc
+                  << std::setw(6) << r.lost << std::setw(7) << r.gained << std::setw(8) << r.bkgFlips
+                  << std::setprecision(5) << std::setw(10) << (nev ? r.sumDiff / nev : 0) << std::setw(9) << r.maxDiff
+                  << std::setprecision(3) << std::setw(8) << 100. * r.massSat / std::max(1ul, r.npairs)
+                  << std::setw(8) << 100. * r.inputSat / std::max(1ul, r.ninputs)
+                  << std::setw(7) << r.lut << std::setw(5) << r.dsp << (r.ok ? "  yes" : "  no") << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    // Narrowest ok width of each type, the others at the firmware setting
+    const std::vector<int> & fw = results[0].params;
+    std::vector<int> best = fw;
+    std::cout << std::endl;
+    for (const TypeGroup & g : TYPE_GROUPS)
+    {
+        int bestWidth = -1;
+        for (const SweepResult & r : results)
+        {
+            bool others = true;
+            for (int k = 0; k < Firmware::NPARAMS; k++)
+                if ((k < g.first || k >= g.first + g.size) && r.params[k] != fw[k]) others = false;
+            int width = r.params[g.first];
+            if (!others || !r.ok || (bestWidth >= 0 && width >= bestWidth)) continue;
+            bestWidth = width;
+            for (int k = g.first; k < g.first + g.size; k++) best[k] = r.params[k];
+        }
+        std::cout << "*** " << std::left << std::setw(12) << g.name << std::right << ": ";
+        if (bestWidth < 0) std::cout << "no ok setting" << std::endl;
+        else if (g.size == 1) std::cout << "narrowest ok " << best[g.first] << " (firmware " << fw[g.first] << ")" << std::endl;
+        else std::cout << "narrowest ok <" << best[g.first] << "," << best[g.first+1] << "> (firmware <" << fw[g.first] << "," << fw[g.first+1] << ">)" << std::endl;
+    }
+    std::cout << "*** Combination to add to SweepGrid and check: Precision<";
+    for (int k = 0; k < Firmware::NPARAMS; k++) std::cout << (k ? ", " : "") << best[k];
+    std::cout << ">" << std::endl;
+
+    std::cout << "*** Firmware setting vs C model (get_event_inputs/get_event_scores): " << results[0].fwMismatch
+              << " / " << events.size() << " events differ" << std::endl;
+    return results[0].fwMismatch > 0;
+}
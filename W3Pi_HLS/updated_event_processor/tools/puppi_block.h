@@ -0,0 +1,47 @@
+#ifndef PUPPI_BLOCK_H
+#define PUPPI_BLOCK_H
+
+#include "../src/data.h"
+#include "batch_unpack.h"
+
+// ------------------------------------------------------------------
+// PuppiBlock: one event as aligned struct-of-arrays of raw int16 fields (capacity NPUPPI_MAX)
+//
+// Same raw values as the ap_* fields of Puppi (see batch_unpack.h), so that the
+// conversions to and from the array-of-structs used by the firmware are lossless.
+typedef PuppiSoA<NPUPPI_MAX> PuppiBlock;
+
+// Fill the ap_* fields of candidate i from the block
+inline void toPuppi(const PuppiBlock & block, unsigned int i, Puppi & p)
+{
+    p.hwPt(13,0) = block.pt[i];
+    p.hwEta = block.eta[i];
+    p.hwPhi = block.phi[i];
+    p.hwID  = block.id[i];
+    p.hwZ0  = block.z0[i];
+}
+
+// Block -> AoS, all NPUPPI_MAX slots (empty slots are cleared candidates)
+inline void toAoS(const PuppiBlock & block, Puppi out[NPUPPI_MAX])
+{
+    for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+        toPuppi(block, i, out[i]);
+}
+
+// AoS -> block, n candidates and zeros in the remaining slots
+inline void fromAoS(const Puppi in[NPUPPI_MAX], unsigned int n, PuppiBlock & block)
+{
+    block.size = n;
+    for (unsigned int i = 0; i < n; i++)
+    {
+        block.pt [i] = ap_uint<14>(in[i].hwPt(13,0)).to_int();
+        block.eta[i] = in[i].hwEta.to_int();
+        block.phi[i] = in[i].hwPhi.to_int();
+        block.id [i] = in[i].hwID.to_int();
+        block.z0 [i] = in[i].hwZ0.to_int();
+    }
+    for (unsigned int i = n; i < PuppiBlock::capacity; i++)
+        block.pt[i] = block.eta[i] = block.phi[i] = block.id[i] = block.z0[i] = 0;
+}
+
+#endif
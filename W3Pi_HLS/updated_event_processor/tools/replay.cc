@@ -0,0 +1,324 @@
+// ------------------------------------------------------------------
+// Rate-controlled replay of dump files through EventProcessor7f
+//
+// Usage:
+//   replay [-j nworkers] [--tmux N | --rate HZ | --bx-spacing] [--scale S] [--queue-max Q]
+//          [--loop K] [-n maxevents] [-o histograms.txt] file1.dump [file2.dump ...]
+//
+// A producer thread injects the events into a FIFO at a fixed schedule, and nworkers threads
+// pop them, unpack them and run EventProcessor7f (same event selection as the testbench).
+// Arrival schedule (scaled to wall clock by S, e.g. --scale 1000 = 1000x slower than real time):
+//  --tmux N      one event every N bunch crossings (25 ns), default N = 1 (40 MHz)
+//  --rate HZ     fixed event rate
+//  --bx-spacing  spacing given by the orbit/bunch crossing numbers of the event headers
+// With --queue-max, events arriving when the queue already holds Q events are dropped.
+// Measured per event:
+//  - latency:      completion time - scheduled arrival time
+//  - service time: completion time - start of processing
+//  - queue depth:  events waiting in the queue at each arrival
+//  - lag:          delay of the producer wrt the schedule (the producer itself cannot keep up)
+#include "../src/event_processor.h"
+#include "dump_reader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BX_NS 25.0  // bunch crossing spacing
+#define N_BX 3564   // bunch crossings per orbit
+
+typedef std::chrono::steady_clock Clock;
+
+// ------------------------------------------------------------------
+// Histogram with logarithmic bins (10 per decade) from 1 ns to 1e10 ns, plus under/overflow
+struct LogHistogram {
+    static constexpr int BINS_PER_DECADE = 10;
+    static constexpr int NDECADES = 10;
+    static constexpr int NBINS = BINS_PER_DECADE * NDECADES + 2;
+
+    std::vector<uint64_t> counts;
+    uint64_t entries;
+    double sum, max;
+
+    LogHistogram() : counts(NBINS, 0), entries(0), sum(0), max(0) {}
+
+    static double lowEdge(int bin) { return bin == 0 ? 0 : std::pow(10., double(bin - 1) / BINS_PER_DECADE); }
+
+    void fill(double ns)
+    {
+        int bin = ns < 1 ? 0 : 1 + int(std::floor(std::log10(ns) * BINS_PER_DECADE));
+        counts[std::min(bin, NBINS - 1)]++;
+        entries++;
+        sum += ns;
+        max = std::max(max, ns);
+    }
+
+    void add(const LogHistogram & h)
+    {
+        for (int i = 0; i < NBINS; i++) counts[i] += h.counts[i];
+        entries += h.entries;
+        sum += h.sum;
+        max = std::max(max, h.max);
+    }
+
+    // Upper edge of the bin containing the quantile q
+    double quantile(double q) const
+    {
+        uint64_t target = std::ceil(q * entries), cum = 0;
+        for (int i = 0; i < NBINS - 1; i++)
+        {
+            cum += counts[i];
+            if (cum >= target && cum > 0) return std::min(lowEdge(i + 1), max);
+        }
+        return max;
+    }
+};
+
+// ------------------------------------------------------------------
+// Histogram of small integers (queue depth), grows as needed
+struct DepthHistogram {
+    std::vector<uint64_t> counts;
+    uint64_t entries = 0;
+
+    void fill(size_t depth)
+    {
+        if (depth >= counts.size()) counts.resize(depth + 1, 0);
+        counts[depth]++;
+        entries++;
+    }
+
+    size_t quantile(double q) const
+    {
+        uint64_t target = std::ceil(q * entries), cum = 0;
+        for (size_t i = 0; i < counts.size(); i++)
+        {
+            cum += counts[i];
+            if (cum >= target && cum > 0) return i;
+        }
+        return counts.empty() ? 0 : counts.size() - 1;
+    }
+};
+
+// Event in the queue
+struct Job {
+    size_t iev;
+    Clock::time_point arrival;
+};
+
+// Per-worker measurements, merged at the end
+struct WorkerStats {
+    LogHistogram latency, service;
+    size_t nprocessed = 0;
+};
+
+// Global event number -> (file, event in file)
+struct EventRef {
+    unsigned int ifile;
+    size_t ievt;
+};
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-j nworkers] [--tmux N | --rate HZ | --bx-spacing] [--scale S] [--queue-max Q]"
+              << " [--loop K] [-n maxevents] [-o histograms.txt] file1.dump [file2.dump ...]" << std::endl;
+}
+
+void printLog(const char * name, const LogHistogram & h)
+{
+    if (h.entries == 0) return;
+    std::cout << "*** " << std::left << std::setw(13) << name << std::right << std::setprecision(4)
+              << " mean " << h.sum / h.entries << " ns, p50 < " << h.quantile(0.5) << " ns, p90 < " << h.quantile(0.9)
+              << " ns, p99 < " << h.quantile(0.99) << " ns, p99.9 < " << h.quantile(0.999) << " ns, max " << h.max << " ns" << std::endl;
+}
+
+void writeLog(std::ofstream & out, const char * name, const LogHistogram & h)
+{
+    for (int i = 0; i < LogHistogram::NBINS; i++)
+    {
+        double high = (i == LogHistogram::NBINS - 1) ? INFINITY : LogHistogram::lowEdge(i + 1);
+        out << name << " " << LogHistogram::lowEdge(i) << " " << high << " " << h.counts[i] << "\n";
+    }
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    unsigned int nworkers = 1, loops = 1;
+    size_t maxevents = 0, queueMax = 0; // 0 = unlimited
+    double tmux = 1, rate = 0, scale = 1;
+    bool bxSpacing = false;
+    std::string outname;
+    std::vector<std::string> fnames;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!std::strcmp(argv[i], "-j")          && i+1 < argc) nworkers  = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "--tmux")      && i+1 < argc) tmux      = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--rate")      && i+1 < argc) rate      = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--scale")     && i+1 < argc) scale     = std::atof(argv[++i]);
+        else if (!std::strcmp(argv[i], "--queue-max") && i+1 < argc) queueMax  = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--loop")      && i+1 < argc) loops     = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-n")          && i+1 < argc) maxevents = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "-o")          && i+1 < argc) outname   = argv[++i];
+        else if (!std::strcmp(argv[i], "--bx-spacing")) bxSpacing = true;
+        else if (argv[i][0] == '-') { usage(argv[0]); return 1; }
+        else fnames.push_back(argv[i]);
+    }
+    if (fnames.empty() || nworkers == 0 || loops == 0 || scale <= 0 || tmux <= 0) { usage(argv[0]); return 1; }
+
+    // Map and index all inputs
+    std::vector<std::unique_ptr<DumpReader>> readers;
+    std::vector<EventRef> events;
+    for (unsigned int ifile = 0; ifile < fnames.size(); ifile++)
+    {
+        readers.emplace_back(new DumpReader(fnames[ifile]));
+        for (size_t ievt = 0; ievt < readers.back()->size(); ievt++)
+        {
+            if (maxevents && events.size() >= maxevents) break;
+            events.push_back({ifile, ievt});
+        }
+    }
+    if (events.empty()) { std::cout << "No events" << std::endl; return 1; }
+
+    // Arrival time of each event wrt the start, in ns
+    size_t njobs = events.size() * loops;
+    std::vector<double> schedule(njobs);
+    double period = (rate > 0 ? 1e9 / rate : tmux * BX_NS) * scale;
+    for (size_t j = 0, last = 0; j < njobs; j++)
+    {
+        if (!bxSpacing) { schedule[j] = j * period; continue; }
+        // absolute bunch crossing, at least one bx after the previous event (new file or loop)
+        const EventInfo & info = readers[events[j % events.size()].ifile]->info(events[j % events.size()].ievt);
+        size_t absBx = size_t(info.orbit) * N_BX + info.bx;
+        double dt = (j == 0 || absBx <= last) ? (j == 0 ? 0 : 1) : double(absBx - last);
+        schedule[j] = (j == 0 ? 0 : schedule[j-1]) + dt * BX_NS * scale;
+        last = absBx;
+    }
+
+    // FIFO between producer and workers
+    std::deque<Job> queue;
+    std::mutex lock;
+    std::condition_variable ready;
+    bool done = false;
+    std::vector<WorkerStats> stats(nworkers);
+
+    std::vector<std::thread> workers;
+    for (unsigned int w = 0; w < nworkers; w++)
+    {
+        workers.emplace_back([&, w]() {
+            WorkerStats & st = stats[w];
+            Puppi inputs[NPUPPI_MAX];
+            while (true)
+            {
+                Job job;
+                {
+                    std::unique_lock<std::mutex> guard(lock);
+                    ready.wait(guard, [&]() { return done || !queue.empty(); });
+                    if (queue.empty()) return;
+                    job = queue.front();
+                    queue.pop_front();
+                }
+                Clock::time_point start = Clock::now();
+
+                const EventRef & ref = events[job.iev];
+                PuppiSpan span = readers[ref.ifile]->event(ref.ievt);
+                // Same event selection as the testbench
+                if (span.size >= 3 && span.size <= NPUPPI_MAX)
+                {
+                    for (unsigned int i = 0; i < span.size; i++)
+                        inputs[i].unpack(span[i]);
+                    for (unsigned int i = span.size; i < NPUPPI_MAX; i++)
+                        inputs[i].clear();
+                    w3p_bdt::score_t max_score;
+                    EventProcessor7f(inputs, max_score);
+                }
+
+                Clock::time_point end = Clock::now();
+                st.latency.fill(std::chrono::duration<double, std::nano>(end - job.arrival).count());
+                st.service.fill(std::chrono::duration<double, std::nano>(end - start).count());
+                st.nprocessed++;
+            }
+        });
+    }
+
+    // Producer: inject each event at its scheduled time
+    LogHistogram lag;
+    DepthHistogram depth;
+    size_t ndropped = 0;
+    Clock::time_point t0 = Clock::now() + std::chrono::milliseconds(10);
+    for (size_t j = 0; j < njobs; j++)
+    {
+        Clock::time_point arrival = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::nano>(schedule[j]));
+        // sleep when far from the next arrival, then spin
+        Clock::time_point now = Clock::now();
+        if (arrival - now > std::chrono::microseconds(200))
+            std::this_thread::sleep_for(arrival - now - std::chrono::microseconds(100));
+        while ((now = Clock::now()) < arrival) {}
+        lag.fill(std::chrono::duration<double, std::nano>(now - arrival).count());
+
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            depth.fill(queue.size());
+            if (queueMax && queue.size() >= queueMax) { ndropped++; continue; }
+            queue.push_back({j % events.size(), arrival});
+        }
+        ready.notify_one();
+    }
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        done = true;
+    }
+    ready.notify_all();
+    for (std::thread & t : workers) t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    // Summary
+    WorkerStats total;
+    for (const WorkerStats & st : stats)
+    {
+        total.latency.add(st.latency);
+        total.service.add(st.service);
+        total.nprocessed += st.nprocessed;
+    }
+    // mean spacing of the schedule (= period unless --bx-spacing)
+    double spacing = njobs > 1 ? schedule.back() / (njobs - 1) : period;
+    double offered = 1e9 / spacing;
+    std::cout << "*** Replayed " << njobs << " events (" << events.size() << " x " << loops << ") with " << nworkers << " workers" << std::endl;
+    std::cout << "*** Offered rate " << offered << " Hz" << (scale != 1 ? " (scaled)" : "")
+              << ", achieved " << total.nprocessed / elapsed << " Hz, dropped " << ndropped << std::endl;
+    printLog("latency", total.latency);
+    printLog("service time", total.service);
+    printLog("producer lag", lag);
+    std::cout << "*** queue depth  p50 " << depth.quantile(0.5) << ", p90 " << depth.quantile(0.9) << ", p99 " << depth.quantile(0.99)
+              << ", max " << (depth.counts.empty() ? 0 : depth.counts.size() - 1) << std::endl;
+
+    // Histograms: "name low_edge high_edge count" (ns for the times)
+    if (!outname.empty())
+    {
+        std::ofstream out(outname);
+        if (!out.good())
+        {
+            std::cout << "Cannot open output file " << outname << std::endl;
+            return 1;
+        }
+        writeLog(out, "latency", total.latency);
+        writeLog(out, "service", total.service);
+        writeLog(out, "lag", lag);
+        for (size_t i = 0; i < depth.counts.size(); i++)
+            out << "depth " << i << " " << i + 1 << " " << depth.counts[i] << "\n";
+        std::cout << "*** Histograms written to " << outname << std::endl;
+    }
+
+    return 0;
+}
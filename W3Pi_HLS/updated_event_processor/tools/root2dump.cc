@@ -0,0 +1,216 @@
+// ------------------------------------------------------------------
+// Convert L1Puppi ntuples (.root) to firmware input (.dump + .idx sidecar)
+//
+// Usage:
+//   root2dump [-j nthreads] [--tree Events] [--prefix L1Puppi] [--max-cands N]
+//             [--z0-unit cm|mm] [--run N] input.root [output.dump]
+//
+// Reads the <prefix>_pt, _eta, _phi, _pdgId and _z0 branches (same names as in
+// W3PiDNN/utils/RootDF_utils.h) with RDataFrame and implicit multi-threading,
+// quantizes them with Puppi::toHwPt/toHwEta/toHwPhi/toHwZ0 and writes the events
+// in tree order. Two event loops are run:
+//  1. number of candidates per entry -> offset of each event in the output
+//  2. quantization and packing, each event written directly at its own offset
+// so the output is ordered and identical for any number of threads.
+// The header bunch crossing and orbit are the entry number modulo/divided by 3564.
+#include "../src/data.h"
+#include "dump_reader.h"
+#include "dump_index.h"
+
+#include <ROOT/RDataFrame.hxx>
+#include <ROOT/RVec.hxx>
+#include <TFile.h>
+#include <TROOT.h>
+#include <TTree.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define N_BX 3564 // bunch crossings per orbit
+
+using cRVecF = const ROOT::VecOps::RVec<Float_t>&;
+using cRVecI = const ROOT::VecOps::RVec<Int_t>&;
+
+// ------------------------------------------------------------------
+// PDG id -> Puppi::PID
+unsigned int toHwID(int pdgId)
+{
+    switch (pdgId)
+    {
+        case   22: return Puppi::Gamma;
+        case -211: return Puppi::HMinus;
+        case  211: return Puppi::HPlus;
+        case   11: return Puppi::EMinus;
+        case  -11: return Puppi::EPlus;
+        case   13: return Puppi::MuMinus;
+        case  -13: return Puppi::MuPlus;
+        default:   return Puppi::H0;
+    }
+}
+
+// ------------------------------------------------------------------
+// Writable memory map of the output file, resized to nwords
+class OutputMap {
+    public:
+        OutputMap(const std::string & fname, size_t nwords) : nwords_(nwords), words_(nullptr)
+        {
+            fd_ = open(fname.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+            if (fd_ < 0)
+                throw std::runtime_error("cannot open " + fname + ": " + std::strerror(errno));
+            if (nwords == 0) return;
+            void * addr = MAP_FAILED;
+            if (ftruncate(fd_, nwords * sizeof(uint64_t)) == 0)
+                addr = mmap(nullptr, nwords * sizeof(uint64_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (addr == MAP_FAILED)
+            {
+                std::string err = std::strerror(errno);
+                close(fd_);
+                throw std::runtime_error("cannot map " + fname + ": " + err);
+            }
+            words_ = static_cast<uint64_t *>(addr);
+        }
+        ~OutputMap()
+        {
+            if (words_) munmap(words_, nwords_ * sizeof(uint64_t));
+            if (fd_ >= 0) close(fd_);
+        }
+        uint64_t * words() { return words_; }
+
+    private:
+        size_t nwords_;
+        int fd_;
+        uint64_t * words_;
+};
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-j nthreads] [--tree Events] [--prefix L1Puppi] [--max-cands N]"
+              << " [--z0-unit cm|mm] [--run N] input.root [output.dump]" << std::endl;
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    unsigned int nthreads = 0;
+    std::string tree = "Events", prefix = "L1Puppi", z0unit = "cm";
+    unsigned int maxCands = 255, run = 0;
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = (i+1 < argc);
+        if      (arg == "-j"          && hasValue) nthreads = std::atoi(argv[++i]);
+        else if (arg == "--tree"      && hasValue) tree     = argv[++i];
+        else if (arg == "--prefix"    && hasValue) prefix   = argv[++i];
+        else if (arg == "--max-cands" && hasValue) maxCands = std::atoi(argv[++i]);
+        else if (arg == "--z0-unit"   && hasValue) z0unit   = argv[++i];
+        else if (arg == "--run"       && hasValue) run      = std::atoi(argv[++i]);
+        else if (arg[0] == '-') { usage(argv[0]); return 1; }
+        else files.push_back(arg);
+    }
+    if (files.empty() || files.size() > 2 || maxCands > 255 || (z0unit != "cm" && z0unit != "mm"))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+    std::string inName = files[0];
+    std::string outName = files.size() == 2 ? files[1] : inName.substr(0, inName.find_last_of('.')) + ".dump";
+    const float z0scale = (z0unit == "cm") ? 10.f : 1.f; // toHwZ0 takes mm
+
+    // 0 = all cores
+    if (nthreads != 1) ROOT::EnableImplicitMT(nthreads);
+
+    try
+    {
+        // Number of entries, so that per-entry arrays can be filled by any thread
+        ULong64_t nentries = 0;
+        {
+            std::unique_ptr<TFile> fin(TFile::Open(inName.c_str()));
+            if (!fin || fin->IsZombie()) throw std::runtime_error("cannot open " + inName);
+            TTree * t = fin->Get<TTree>(tree.c_str());
+            if (!t) throw std::runtime_error("no tree " + tree + " in " + inName);
+            nentries = t->GetEntries();
+        }
+
+        ROOT::RDataFrame df(tree, inName);
+        const std::string bPt = prefix + "_pt", bEta = prefix + "_eta", bPhi = prefix + "_phi";
+        const std::string bId = prefix + "_pdgId", bZ0 = prefix + "_z0";
+
+        // 1. Candidates per entry (only the pt branch is read)
+        std::vector<unsigned int> ncands(nentries);
+        df.Foreach([&](ULong64_t entry, cRVecF pt) {
+            ncands[entry] = std::min<size_t>(pt.size(), maxCands);
+        }, {"rdfentry_", bPt});
+
+        // Offsets and index
+        std::vector<EventInfo> index(nentries);
+        uint64_t nwords = 0, ntruncated = 0;
+        for (ULong64_t entry = 0; entry < nentries; entry++)
+        {
+            EventInfo & info = index[entry];
+            info.offset = nwords;
+            info.npuppi = ncands[entry];
+            info.bx     = entry % N_BX;
+            info.orbit  = entry / N_BX;
+            info.run    = run;
+            info.error  = false;
+            nwords += 1 + ncands[entry];
+        }
+
+        // 2. Quantize, pack and write each event at its offset
+        OutputMap out(outName, nwords);
+        uint64_t * words = out.words();
+        std::vector<unsigned char> truncated(nentries, 0);
+        df.Foreach([&](ULong64_t entry, cRVecF pt, cRVecF eta, cRVecF phi, cRVecI pdgId, cRVecF z0) {
+            const EventInfo & info = index[entry];
+            EventHeader header;
+            header.npuppi = info.npuppi;
+            header.bx     = info.bx;
+            header.orbit  = info.orbit;
+            header.run    = info.run;
+            header.error  = false;
+            header.valid  = true;
+
+            uint64_t * ev = words + info.offset;
+            ev[0] = header.encode();
+            for (unsigned int i = 0; i < info.npuppi; i++)
+            {
+                Puppi p;
+                p.hwPt  = Puppi::toHwPt(pt[i]);
+                p.hwEta = Puppi::toHwEta(eta[i]);
+                p.hwPhi = Puppi::toHwPhi(phi[i]);
+                p.hwID  = toHwID(pdgId[i]);
+                p.hwZ0  = Puppi::toHwZ0(z0[i] * z0scale);
+                ev[1 + i] = p.pack();
+            }
+            truncated[entry] = (pt.size() > info.npuppi);
+        }, {"rdfentry_", bPt, bEta, bPhi, bId, bZ0});
+
+        for (unsigned char t : truncated) ntruncated += t;
+
+        dump_index::write(dump_index::indexName(outName), index, words, nwords);
+
+        std::cout << "*** " << inName << " -> " << outName << ": " << nentries << " events, "
+                  << nwords - nentries << " candidates";
+        if (ntruncated) std::cout << ", " << ntruncated << " events truncated to " << maxCands << " candidates";
+        std::cout << std::endl;
+    }
+    catch (const std::exception & e)
+    {
+        std::cout << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
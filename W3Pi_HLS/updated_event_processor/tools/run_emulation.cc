@@ -0,0 +1,370 @@
+// ------------------------------------------------------------------
+// Multi-threaded C++ emulation of EventProcessor7f (and EventProcessor_ref) over whole dump files
+//
+// Usage:
+//   run_emulation [-j nthreads] [-o scores.txt] [-c columns_dir] [-n maxevents] [--no-fw] [--no-ref] [--fast] [--fast-ref] [--check-unpack] file1.dump [file2.dump ...]
+//
+// Events of all files are sharded in chunks over a work-stealing pool and unpacked in batch
+// (batch_unpack.h, checked bit-by-bit against Puppi::unpack with --check-unpack); per-event
+// results are written in input order as:
+//   ifile ievent npuppi processed max_score_fw max_score_ref
+// With -c the per-event and per-triplet FW results (header fields, selected candidates,
+// BDT inputs and scores) are written instead to a columnar dataset (column_writer.h);
+// the text output is then only written if -o is also given.
+// With --fast the FW results are computed with the struct-of-arrays CPU fast path (fast_path.h)
+// instead of the ap_* C model. With --fast-ref the reference sorts (pT, index) keys with the
+// SIMD bitonic sort of simd_sort.h instead of std::stable_sort on the candidates (same order).
+// Must run from a directory containing conifer_binary_featV4_finalFit_v5.json (reference BDT).
+#include "../src/event_processor.h"
+#include "column_writer.h"
+#include "dump_reader.h"
+#include "fast_path.h"
+#include "puppi_block.h"
+#include "simd_sort.h"
+#include "work_stealing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#define CHUNK_SIZE 64 // events per task
+
+// Per-event emulation result
+struct EventResult {
+    unsigned int npuppi;
+    bool processed;
+    float max_score_fw;
+    float max_score_ref;
+};
+
+// Global event number -> (file, event in file)
+struct EventRef {
+    unsigned int ifile;
+    size_t ievt;
+};
+
+void usage(const char * exe)
+{
+    std::cout << "Usage: " << exe << " [-j nthreads] [-o scores.txt] [-c columns_dir] [-n maxevents] [--no-fw] [--no-ref] [--fast] [--fast-ref] [--check-unpack] file1.dump [file2.dump ...]" << std::endl;
+}
+
+// EventProcessor7f split in its stages, keeping the intermediate results
+void EventProcessor7f_staged(const Puppi input[NPUPPI_MAX], Puppi selected[NPUPPI_SEL],
+                             w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features],
+                             w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::score_t & max_score)
+{
+    ap_uint<NPUPPI_MAX> masked;
+    masker(input, masked);
+    Puppi slimmed[NPUPPI_MAX];
+    slimmer(input, masked, slimmed);
+    sortkey_t sorted[NPUPPI_MAX];
+    sorter7f(slimmed, sorted);
+    selector7f(slimmed, sorted, selected);
+    get_event_inputs(selected, BDT_inputs);
+    get_event_scores(BDT_inputs, BDT_scores);
+
+    // get_highest_score sorts its input in place
+    w3p_bdt::score_t sorted_scores[NTRIPLETS];
+    for (unsigned int i = 0; i < NTRIPLETS; i++)
+        sorted_scores[i] = BDT_scores[i];
+    get_highest_score(sorted_scores, max_score);
+}
+
+// Same outputs with the fast path (block is masked in place)
+void EventProcessor7f_fast_staged(PuppiBlock & block, Puppi selected[NPUPPI_SEL],
+                                  w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features],
+                                  w3p_bdt::score_t BDT_scores[NTRIPLETS], w3p_bdt::score_t & max_score)
+{
+    fast_path::mask(block);
+    uint8_t idx[NPUPPI_SEL];
+    fast_path::order(block, idx);
+    for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+        toPuppi(block, idx[i], selected[i]);
+    fast_path::event_inputs(block, idx, BDT_inputs);
+    for (unsigned int i = 0; i < NTRIPLETS; i++)
+    {
+        w3p_bdt::bdt.decision_function(BDT_inputs[i], &BDT_scores[i]);
+        if (i == 0 || BDT_scores[i] > max_score) max_score = BDT_scores[i];
+    }
+}
+
+// EventProcessor_ref with merger_ref + selector_ref replaced by the SIMD sort of the
+// (pT, index) keys: same selected candidates as std::stable_sort on decreasing pT
+void EventProcessor_ref_fast(const Puppi input[NPUPPI_MAX], w3p_bdt::score_t & max_score)
+{
+    ap_uint<NPUPPI_MAX> masked;
+    masker_ref(input, masked);
+    Puppi slimmed[NPUPPI_MAX];
+    slimmer_ref(input, masked, slimmed);
+
+    uint32_t keys[NPUPPI_MAX];
+    for (unsigned int i = 0; i < NPUPPI_MAX; i++)
+        keys[i] = fast_path::sort_key(ap_uint<14>(slimmed[i].hwPt(13,0)).to_int(), i);
+    simd_sort::sort_desc(keys, NPUPPI_MAX);
+    Puppi selected[NPUPPI_SEL];
+    for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+        selected[i] = slimmed[fast_path::key_index(keys[i])];
+
+    w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
+    get_event_inputs_ref(selected, BDT_inputs);
+    w3p_bdt::score_t BDT_scores[NTRIPLETS];
+    get_event_scores_ref(BDT_inputs, BDT_scores);
+    get_highest_score_ref(BDT_scores, max_score);
+}
+
+// Per-chunk buffers of the columnar output
+struct ColumnBuffers {
+    std::vector<uint64_t> event;
+    std::vector<uint16_t> file, npuppi, bx;
+    std::vector<uint32_t> orbit;
+    std::vector<uint8_t>  run, error, processed;
+    std::vector<uint64_t> selected;
+    std::vector<float>    bdt_inputs, bdt_scores, max_score, max_score_ref;
+
+    ColumnBuffers() :
+        event(CHUNK_SIZE), file(CHUNK_SIZE), npuppi(CHUNK_SIZE), bx(CHUNK_SIZE), orbit(CHUNK_SIZE),
+        run(CHUNK_SIZE), error(CHUNK_SIZE), processed(CHUNK_SIZE), selected(CHUNK_SIZE*NPUPPI_SEL),
+        bdt_inputs(CHUNK_SIZE*NTRIPLETS*w3p_bdt::n_features), bdt_scores(CHUNK_SIZE*NTRIPLETS),
+        max_score(CHUNK_SIZE), max_score_ref(CHUNK_SIZE) {}
+};
+
+// Column ids, in the same order as the ColumnBuffers members
+enum ColumnId { C_EVENT, C_FILE, C_NPUPPI, C_BX, C_ORBIT, C_RUN, C_ERROR, C_PROCESSED,
+                C_SELECTED, C_BDT_INPUTS, C_BDT_SCORES, C_MAX_SCORE, C_MAX_SCORE_REF };
+
+void addColumns(ColumnWriter & writer)
+{
+    writer.addColumn("event",         ColumnWriter::U64);
+    writer.addColumn("file",          ColumnWriter::U16);
+    writer.addColumn("npuppi",        ColumnWriter::U16);
+    writer.addColumn("bx",            ColumnWriter::U16);
+    writer.addColumn("orbit",         ColumnWriter::U32);
+    writer.addColumn("run",           ColumnWriter::U8);
+    writer.addColumn("error",         ColumnWriter::U8);
+    writer.addColumn("processed",     ColumnWriter::U8);
+    writer.addColumn("selected",      ColumnWriter::U64, NPUPPI_SEL);                    // packed Puppi words
+    writer.addColumn("bdt_inputs",    ColumnWriter::F32, NTRIPLETS*w3p_bdt::n_features); // [triplet][feature]
+    writer.addColumn("bdt_scores",    ColumnWriter::F32, NTRIPLETS);
+    writer.addColumn("max_score",     ColumnWriter::F32);
+    writer.addColumn("max_score_ref", ColumnWriter::F32);
+}
+
+void writeColumns(ColumnWriter & writer, uint64_t firstRow, uint64_t nrows, const ColumnBuffers & b)
+{
+    writer.write(C_EVENT,         firstRow, nrows, b.event.data());
+    writer.write(C_FILE,          firstRow, nrows, b.file.data());
+    writer.write(C_NPUPPI,        firstRow, nrows, b.npuppi.data());
+    writer.write(C_BX,            firstRow, nrows, b.bx.data());
+    writer.write(C_ORBIT,         firstRow, nrows, b.orbit.data());
+    writer.write(C_RUN,           firstRow, nrows, b.run.data());
+    writer.write(C_ERROR,         firstRow, nrows, b.error.data());
+    writer.write(C_PROCESSED,     firstRow, nrows, b.processed.data());
+    writer.write(C_SELECTED,      firstRow, nrows, b.selected.data());
+    writer.write(C_BDT_INPUTS,    firstRow, nrows, b.bdt_inputs.data());
+    writer.write(C_BDT_SCORES,    firstRow, nrows, b.bdt_scores.data());
+    writer.write(C_MAX_SCORE,     firstRow, nrows, b.max_score.data());
+    writer.write(C_MAX_SCORE_REF, firstRow, nrows, b.max_score_ref.data());
+}
+
+// Bit-level comparison of two candidates
+inline bool samePuppi(const Puppi & a, const Puppi & b)
+{
+    return a.pack() == b.pack();
+}
+
+int main(int argc, char **argv) {
+
+    // Parse command line
+    unsigned int nthreads = 0; // 0 = all available cores
+    size_t maxevents = 0;      // 0 = all events
+    std::string outname = "scores.txt", colname;
+    bool textOutput = true, explicitText = false;
+    bool runFW = true, runRef = true, fast = false, fastRef = false, checkUnpack = false;
+    std::vector<std::string> fnames;
+    for (int i = 1; i < argc; i++)
+    {
+        if      (!std::strcmp(argv[i], "-j") && i+1 < argc) nthreads  = std::atoi(argv[++i]);
+        else if (!std::strcmp(argv[i], "-o") && i+1 < argc) { outname = argv[++i]; explicitText = true; }
+        else if (!std::strcmp(argv[i], "-c") && i+1 < argc) colname   = argv[++i];
+        else if (!std::strcmp(argv[i], "-n") && i+1 < argc) maxevents = std::atol(argv[++i]);
+        else if (!std::strcmp(argv[i], "--no-fw"))  runFW  = false;
+        else if (!std::strcmp(argv[i], "--no-ref")) runRef = false;
+        else if (!std::strcmp(argv[i], "--fast"))   fast   = true;
+        else if (!std::strcmp(argv[i], "--fast-ref")) fastRef = true;
+        else if (!std::strcmp(argv[i], "--check-unpack")) checkUnpack = true;
+        else if (argv[i][0] == '-') { usage(argv[0]); return 1; }
+        else fnames.push_back(argv[i]);
+    }
+    if (fnames.empty()) { usage(argv[0]); return 1; }
+    if (!colname.empty()) textOutput = explicitText;
+
+    // Map and index all inputs
+    std::vector<std::unique_ptr<DumpReader>> readers;
+    std::vector<EventRef> events;
+    for (unsigned int ifile = 0; ifile < fnames.size(); ifile++)
+    {
+        readers.emplace_back(new DumpReader(fnames[ifile]));
+        for (size_t ievt = 0; ievt < readers.back()->size(); ievt++)
+        {
+            if (maxevents && events.size() >= maxevents) break;
+            events.push_back({ifile, ievt});
+        }
+        std::cout << "*** " << fnames[ifile] << ": " << readers.back()->size() << " events" << std::endl;
+    }
+
+    // Columnar output: one row per event, in input order
+    std::unique_ptr<ColumnWriter> columns;
+    if (!colname.empty())
+    {
+        columns.reset(new ColumnWriter(colname));
+        addColumns(*columns);
+        columns->reserve(events.size());
+    }
+
+    // Run the emulation
+    std::vector<EventResult> results(events.size());
+    std::atomic<size_t> nbadUnpack(0);
+    size_t nchunks = (events.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    auto tstart = std::chrono::steady_clock::now();
+
+    work_stealing::parallel_for(nchunks, nthreads, [&](size_t ichunk, unsigned int) {
+        Puppi inputs[NPUPPI_MAX];
+        PuppiBlock block;
+        std::unique_ptr<ColumnBuffers> buf(columns ? new ColumnBuffers() : nullptr);
+        size_t first = ichunk * CHUNK_SIZE;
+        size_t last = std::min(events.size(), (ichunk + 1) * CHUNK_SIZE);
+        for (size_t iev = first; iev < last; iev++)
+        {
+            const DumpReader & reader = *readers[events[iev].ifile];
+            PuppiSpan span = reader.event(events[iev].ievt);
+            EventResult & res = results[iev];
+            res.npuppi = span.size;
+            res.processed = false;
+            res.max_score_fw = 0;
+            res.max_score_ref = 0;
+
+            size_t irow = iev - first;
+            if (buf)
+            {
+                const EventInfo & info = reader.info(events[iev].ievt);
+                buf->event[irow]     = events[iev].ievt;
+                buf->file[irow]      = events[iev].ifile;
+                buf->npuppi[irow]    = info.npuppi;
+                buf->bx[irow]        = info.bx;
+                buf->orbit[irow]     = info.orbit;
+                buf->run[irow]       = info.run;
+                buf->error[irow]     = info.error;
+                buf->processed[irow] = 0;
+                std::fill_n(&buf->selected[irow*NPUPPI_SEL], NPUPPI_SEL, 0);
+                std::fill_n(&buf->bdt_inputs[irow*NTRIPLETS*w3p_bdt::n_features], NTRIPLETS*w3p_bdt::n_features, 0.f);
+                std::fill_n(&buf->bdt_scores[irow*NTRIPLETS], NTRIPLETS, 0.f);
+                buf->max_score[irow] = buf->max_score_ref[irow] = 0;
+            }
+
+            // Same event selection as the testbench
+            if (span.size < 3 || span.size > NPUPPI_MAX) continue;
+
+            block.unpack(span.data, span.size);
+            toAoS(block, inputs);
+
+            if (checkUnpack)
+            {
+                Puppi check;
+                for (unsigned int i = 0; i < span.size; i++)
+                    if (!samePuppi(check.unpack(span[i]), inputs[i])) nbadUnpack++;
+            }
+
+            w3p_bdt::score_t max_score_fw, max_score_ref;
+            if (runFW && buf)
+            {
+                Puppi selected[NPUPPI_SEL];
+                w3p_bdt::input_t BDT_inputs[NTRIPLETS][w3p_bdt::n_features];
+                w3p_bdt::score_t BDT_scores[NTRIPLETS];
+                if (fast) EventProcessor7f_fast_staged(block, selected, BDT_inputs, BDT_scores, max_score_fw);
+                else      EventProcessor7f_staged(inputs, selected, BDT_inputs, BDT_scores, max_score_fw);
+                res.max_score_fw = max_score_fw.to_float();
+
+                for (unsigned int i = 0; i < NPUPPI_SEL; i++)
+                    buf->selected[irow*NPUPPI_SEL + i] = selected[i].pack();
+                for (unsigned int j = 0; j < NTRIPLETS; j++)
+                {
+                    for (unsigned int i = 0; i < w3p_bdt::n_features; i++)
+                        buf->bdt_inputs[(irow*NTRIPLETS + j)*w3p_bdt::n_features + i] = BDT_inputs[j][i].to_float();
+                    buf->bdt_scores[irow*NTRIPLETS + j] = BDT_scores[j].to_float();
+                }
+            }
+            else if (runFW)
+            {
+                if (fast) fast_path::EventProcessor7f(block, max_score_fw);
+                else      EventProcessor7f(inputs, max_score_fw);
+                res.max_score_fw = max_score_fw.to_float();
+            }
+            if (runRef)
+            {
+                if (fastRef) EventProcessor_ref_fast(inputs, max_score_ref);
+                else         EventProcessor_ref(inputs, max_score_ref);
+                res.max_score_ref = max_score_ref.to_float();
+            }
+            res.processed = true;
+
+            if (buf)
+            {
+                buf->processed[irow]     = 1;
+                buf->max_score[irow]     = res.max_score_fw;
+                buf->max_score_ref[irow] = res.max_score_ref;
+            }
+        }
+
+        if (buf) writeColumns(*columns, first, last - first, *buf);
+    });
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - tstart).count();
+
+    if (columns) columns->close();
+
+    // Write results in input order
+    std::ofstream out;
+    if (textOutput)
+    {
+        out.open(outname);
+        if (!out.good())
+        {
+            std::cout << "Cannot open output file " << outname << std::endl;
+            return 1;
+        }
+    }
+    size_t nprocessed = 0, ndiff = 0;
+    for (size_t iev = 0; iev < events.size(); iev++)
+    {
+        const EventResult & res = results[iev];
+        if (textOutput)
+            out << events[iev].ifile << " " << events[iev].ievt << " " << res.npuppi << " " << res.processed << " "
+                << res.max_score_fw << " " << res.max_score_ref << "\n";
+        if (!res.processed) continue;
+        nprocessed++;
+        if (runFW && runRef && res.max_score_fw != res.max_score_ref) ndiff++;
+    }
+
+    std::cout << "*** Processed " << nprocessed << " / " << events.size() << " events in " << elapsed << " s ("
+              << events.size() / elapsed << " events/s)" << std::endl;
+    if (runFW && runRef)
+        std::cout << "*** FW/REF max_score differences: " << ndiff << " / " << nprocessed << std::endl;
+    if (fast || fastRef)
+        std::cout << "*** Key sorting: " << simd_sort::isa() << std::endl;
+    if (checkUnpack)
+        std::cout << "*** Batch unpacking (" << (batch_unpack::simd() ? "AVX2" : "scalar") << ") differences wrt Puppi::unpack: " << nbadUnpack << std::endl;
+    if (textOutput)
+        std::cout << "*** Scores written to " << outname << std::endl;
+    if (columns)
+        std::cout << "*** Columns written to " << colname << "/" << std::endl;
+
+    return (nbadUnpack > 0);
+}
@@ -0,0 +1,150 @@
+#include "simd_sort.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace simd_sort {
+
+    // ------------------------------------------------------------------
+    // Scalar reference
+    void sort_desc_scalar(uint32_t * keys, unsigned int n)
+    {
+        std::sort(keys, keys + n, std::greater<uint32_t>());
+    }
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+    // ------------------------------------------------------------------
+    // One register of L keys, and lane masks
+#ifdef __AVX512F__
+    struct Vec {
+        typedef __m512i reg;
+        typedef __mmask16 mask;
+        static constexpr unsigned int L = 16;
+
+        static reg load(const uint32_t * p)     { return _mm512_load_si512(p); }
+        static void store(uint32_t * p, reg x)  { _mm512_store_si512(p, x); }
+        static reg min(reg a, reg b)            { return _mm512_min_epu32(a, b); }
+        static reg max(reg a, reg b)            { return _mm512_max_epu32(a, b); }
+        static reg lanes()                      { return _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15); }
+
+        // Permutation taking lane i^j into lane i
+        static reg partner(unsigned int j)      { return _mm512_xor_si512(lanes(), _mm512_set1_epi32(j)); }
+        static reg permute(reg x, reg p)        { return _mm512_permutexvar_epi32(p, x); }
+
+        // Lanes i with (i & bit) == 0
+        static mask clear(unsigned int bit)     { return __mmask16(~_mm512_test_epi32_mask(lanes(), _mm512_set1_epi32(bit))); }
+        static mask same(mask a, mask b)        { return __mmask16(~(a ^ b)); }
+        static mask invert(mask a)              { return __mmask16(~a); }
+        static reg blend(mask hi, reg a, reg b) { return _mm512_mask_blend_epi32(hi, a, b); }
+    };
+    const char * isa() { return "AVX-512"; }
+#else
+    struct Vec {
+        typedef __m256i reg;
+        typedef __m256i mask;
+        static constexpr unsigned int L = 8;
+
+        static reg load(const uint32_t * p)     { return _mm256_load_si256(reinterpret_cast<const __m256i *>(p)); }
+        static void store(uint32_t * p, reg x)  { _mm256_store_si256(reinterpret_cast<__m256i *>(p), x); }
+        static reg min(reg a, reg b)            { return _mm256_min_epu32(a, b); }
+        static reg max(reg a, reg b)            { return _mm256_max_epu32(a, b); }
+        static reg lanes()                      { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+
+        static reg partner(unsigned int j)      { return _mm256_xor_si256(lanes(), _mm256_set1_epi32(j)); }
+        static reg permute(reg x, reg p)        { return _mm256_permutevar8x32_epi32(x, p); }
+
+        static mask clear(unsigned int bit)     { return _mm256_cmpeq_epi32(_mm256_and_si256(lanes(), _mm256_set1_epi32(bit)), _mm256_setzero_si256()); }
+        static mask same(mask a, mask b)        { return _mm256_cmpeq_epi32(a, b); }
+        static mask invert(mask a)              { return _mm256_xor_si256(a, _mm256_set1_epi32(-1)); }
+        static reg blend(mask hi, reg a, reg b) { return _mm256_blendv_epi8(a, b, hi); }
+    };
+    const char * isa() { return "AVX2"; }
+#endif
+
+    // ------------------------------------------------------------------
+    // Bitonic sort of n keys (power of 2 >= L, aligned) in descending order: the blocks
+    // of k keys are sorted descending at even k-block positions and ascending at odd ones,
+    // and merged by compare-exchanges at distance j = k/2, ..., 1. Key i keeps the larger
+    // of the pair if it is the lower one ((i & j) == 0) of a descending block ((i & k) == 0)
+    // or the upper one of an ascending block.
+    static constexpr unsigned int LOG2_L = Vec::L == 16 ? 4 : 3;
+
+    void bitonic_desc(uint32_t * a, unsigned int n)
+    {
+        const unsigned int L = Vec::L;
+        Vec::reg partners[LOG2_L];
+        Vec::mask lower[LOG2_L];
+        for (unsigned int b = 0; b < LOG2_L; b++)
+        {
+            partners[b] = Vec::partner(1u << b);
+            lower[b] = Vec::clear(1u << b);
+        }
+
+        for (unsigned int k = 2; k <= n; k *= 2)
+        {
+            // between registers: the direction is the same for the whole register
+            for (unsigned int j = k/2; j >= L; j /= 2)
+            {
+                for (unsigned int i = 0; i < n; i += L)
+                {
+                    if (i & j) continue;
+                    Vec::reg x = Vec::load(a + i), y = Vec::load(a + i + j);
+                    Vec::reg lo = Vec::min(x, y), hi = Vec::max(x, y);
+                    bool descending = !(i & k);
+                    Vec::store(a + i,     descending ? hi : lo);
+                    Vec::store(a + i + j, descending ? lo : hi);
+                }
+            }
+
+            // then inside each register, j = min(k/2, L/2), ..., 1 in one pass
+            unsigned int top = 0;
+            while ((2u << top) < k && (2u << top) < L) top++;
+            Vec::mask takeHi[2][LOG2_L];
+            for (unsigned int b = 0; b <= top; b++)
+            {
+                Vec::mask descending = k < L ? Vec::clear(k) : Vec::same(lower[0], lower[0]);
+                takeHi[0][b] = Vec::same(lower[b], descending);
+                takeHi[1][b] = Vec::invert(takeHi[0][b]);
+            }
+            for (unsigned int i = 0; i < n; i += L)
+            {
+                const Vec::mask * m = takeHi[(k < L || !(i & k)) ? 0 : 1];
+                Vec::reg x = Vec::load(a + i);
+                for (int b = top; b >= 0; b--)
+                {
+                    Vec::reg y = Vec::permute(x, partners[b]);
+                    x = Vec::blend(m[b], Vec::min(x, y), Vec::max(x, y));
+                }
+                Vec::store(a + i, x);
+            }
+        }
+    }
+
+    void sort_desc(uint32_t * keys, unsigned int n)
+    {
+        assert(n <= MAX_KEYS);
+        unsigned int m = Vec::L;
+        while (m < n) m *= 2;
+
+        // zero padding ends up after all the keys
+        alignas(64) uint32_t buf[MAX_KEYS];
+        std::copy(keys, keys + n, buf);
+        std::fill(buf + n, buf + m, 0u);
+        bitonic_desc(buf, m);
+        std::copy(buf, buf + n, keys);
+    }
+#else
+    const char * isa() { return "scalar"; }
+
+    void sort_desc(uint32_t * keys, unsigned int n)
+    {
+        sort_desc_scalar(keys, n);
+    }
+#endif
+
+} // namespace
@@ -0,0 +1,32 @@
+#ifndef SIMD_SORT_H
+#define SIMD_SORT_H
+
+#include <cstdint>
+
+// ------------------------------------------------------------------
+// Sorting network on packed 32-bit keys with SIMD registers
+//
+// Bitonic sort of up to MAX_KEYS keys in descending order, padded to a power of 2
+// with zeros: compare-exchanges between registers are an unsigned min/max pair,
+// the ones inside a register a lane permutation, a min/max and a blend.
+// Uses AVX-512 (16 keys per register) when compiled with -mavx512f, AVX2 (8 keys)
+// with -mavx2, std::sort otherwise.
+//
+// The keys of fast_path.h (raw pT above the inverted candidate index) are unique,
+// so the sorted keys give the same order as std::stable_sort on decreasing pT.
+namespace simd_sort {
+
+    static constexpr unsigned int MAX_KEYS = 256;
+
+    // Instruction set of sort_desc: "AVX-512", "AVX2" or "scalar"
+    const char * isa();
+
+    // Sort n <= MAX_KEYS keys in descending order, in place
+    void sort_desc(uint32_t * keys, unsigned int n);
+
+    // Reference scalar implementation
+    void sort_desc_scalar(uint32_t * keys, unsigned int n);
+
+} // namespace
+
+#endif
@@ -0,0 +1,151 @@
+// ------------------------------------------------------------------
+// Comparators and depth of the sorting network families of bitonic_hybrid.h
+//
+// Usage:
+//   sorting_networks [-n nrandom] [N ...]      (default N: 7 8 13 16 26 52 104 208)
+//
+// For every N, each family (Bitonic, hybrid Bitonic, OddEvenMerge, Pairwise) is run
+// through bitonicSorter on instrumented elements: the comparators and the depth it
+// really uses are checked against sorterComparators/sorterDepth, and the output is
+// checked to be sorted on all 0-1 inputs (N <= 20) or on nrandom random permutations.
+// When the generated comparators are the whole network (OddEvenMerge, Pairwise and the
+// hybrid leaves, but not the Bitonic recursion with its alternating directions), they
+// are also checked on all 0-1 inputs up to N = 26 with sortsZeroOne, 64 inputs at a time.
+// Returns 1 at the first failing network.
+#include "../src/bitonic_hybrid.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace hybridBitonicSort;
+
+static const int NMAX = 208;
+static unsigned long nrandom = 10000;
+
+// Element counting the comparisons and the longest chain of comparators it went through
+struct Wire {
+    int value;
+    mutable int level;
+    static unsigned long comparisons;
+    bool operator<(const Wire & other) const
+    {
+        comparisons++;
+        int l = std::max(level, other.level) + 1;
+        level = other.level = l;
+        return value < other.value;
+    }
+};
+unsigned long Wire::comparisons = 0;
+
+// One run of the network on values, returns false if the output is not in descending order
+template<int N, typename network, bool hybrid>
+bool run(const int values[N], int & comparators, int & depth)
+{
+    Wire a[N];
+    for (int i = 0; i < N; i++) a[i] = {values[i], 0};
+    Wire::comparisons = 0;
+    bitonicSorter<Wire, N, 0, hybrid, network>::run(a, 0);
+    comparators = Wire::comparisons;
+    depth = 0;
+    for (int i = 0; i < N; i++) depth = std::max(depth, a[i].level);
+    for (int i = 1; i < N; i++)
+        if (a[i-1].value < a[i].value) return false;
+    return true;
+}
+
+template<int N, typename network, bool hybrid>
+bool check(const char * name, int n, std::mt19937 & rng)
+{
+    static constexpr int expComparators = sorterComparators<network, hybrid>(N);
+    static constexpr int expDepth = sorterDepth<network, hybrid>(N);
+
+    int values[N], comparators = 0, depth = 0;
+    bool sorted = true, stats = true;
+    unsigned long ntests = 0;
+    auto test = [&]() {
+        int c, d;
+        sorted = sorted && run<N, network, hybrid>(values, c, d);
+        stats = stats && c == expComparators;
+        comparators = c;
+        depth = std::max(depth, d);
+        ntests++;
+    };
+    if (N <= 20)
+    {
+        for (unsigned long bits = 0; bits < (1UL << N); bits++)
+        {
+            for (int i = 0; i < N; i++) values[i] = (bits >> i) & 1;
+            test();
+        }
+    }
+    else
+    {
+        for (int i = 0; i < N; i++) values[i] = i;
+        for (unsigned long k = 0; k < nrandom; k++)
+        {
+            std::shuffle(values, values + N, rng);
+            test();
+        }
+    }
+    stats = stats && depth == expDepth;
+
+    const bool generated = N <= 26 && N <= MAX_ZERO_ONE_SIZE && (!std::is_same<network, Bitonic>::value || (hybrid && HybridLeaf::has(N)));
+    // (n == N, at run time: the compiler would try to evaluate the constexpr call on N)
+    const bool zeroOne = !generated || sortsZeroOne<network, hybrid>(n);
+
+    std::cout << std::setw(4) << N << "  " << std::left << std::setw(14) << name << std::right
+              << std::setw(7) << expComparators << std::setw(7) << expDepth
+              << "   " << (N <= 20 ? "0-1 inputs " : "random     ") << std::setw(8) << ntests;
+    if (!stats) std::cout << "   FAIL: measured " << comparators << " comparators, depth " << depth;
+    if (!sorted) std::cout << "   FAIL: not sorted";
+    if (generated) std::cout << (zeroOne ? "   + 0-1 inputs generated" : "   FAIL: generated not sorted on 0-1 inputs");
+    std::cout << std::endl;
+    return stats && sorted && zeroOne;
+}
+
+template<int N>
+bool check_all(int n, std::mt19937 & rng)
+{
+    bool ok = check<N, Bitonic, false>("Bitonic", n, rng);
+    ok = check<N, Bitonic, true>("Bitonic hybrid", n, rng) && ok;
+    ok = check<N, OddEvenMerge, false>("OddEvenMerge", n, rng) && ok;
+    ok = check<N, Pairwise, false>("Pairwise", n, rng) && ok;
+    return ok;
+}
+
+// N as a template argument, up to NMAX
+template<int N>
+bool dispatch(int n, std::mt19937 & rng)
+{
+    return n == N ? check_all<N>(n, rng) : dispatch<N+1>(n, rng);
+}
+
+template<>
+bool dispatch<NMAX+1>(int n, std::mt19937 & rng)
+{
+    std::cout << "N = " << n << " not in [1, " << NMAX << "]" << std::endl;
+    return false;
+}
+
+int main(int argc, char **argv) {
+
+    std::vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!std::strcmp(argv[i], "-n") && i+1 < argc) nrandom = std::atol(argv[++i]);
+        else sizes.push_back(std::atoi(argv[i]));
+    }
+    if (sizes.empty()) sizes = {7, 8, 13, 16, 26, 52, 104, 208};
+
+    std::mt19937 rng(1);
+    std::cout << "   N  network       compar. depth" << std::endl;
+    bool ok = true;
+    for (int n : sizes) ok = dispatch<1>(n, rng) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,104 @@
+#ifndef WORK_STEALING_H
+#define WORK_STEALING_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ------------------------------------------------------------------
+// Minimal work-stealing parallel loop over [0, ntasks)
+//  - each worker owns a contiguous range of tasks and consumes it from the front
+//  - an idle worker steals the back half of the largest remaining range
+//  - task(itask, iworker) is called exactly once per task
+namespace work_stealing {
+
+    struct TaskRange {
+        std::mutex lock;             // guards every update of [begin, end)
+        std::atomic<size_t> begin;
+        std::atomic<size_t> end;
+
+        size_t left() const
+        {
+            size_t b = begin.load(), e = end.load();
+            return e > b ? e - b : 0;
+        }
+    };
+
+    // Take the next task from the own range
+    inline bool pop_front(TaskRange & r, size_t & itask)
+    {
+        std::lock_guard<std::mutex> guard(r.lock);
+        if (r.left() == 0) return false;
+        itask = r.begin++;
+        return true;
+    }
+
+    // Move the back half of the largest other range into the own (empty) range
+    inline bool steal(std::vector<TaskRange> & ranges, unsigned int self)
+    {
+        while (true)
+        {
+            // Pick the victim with most work left (unlocked peek, re-checked below)
+            unsigned int victim = self;
+            size_t most = 0;
+            for (unsigned int i = 0; i < ranges.size(); i++)
+            {
+                if (i == self) continue;
+                size_t left = ranges[i].left();
+                if (left > most) { most = left; victim = i; }
+            }
+            if (victim == self) return false;
+
+            size_t sbegin, send;
+            {
+                std::lock_guard<std::mutex> guard(ranges[victim].lock);
+                size_t left = ranges[victim].left();
+                if (left == 0) continue; // victim finished meanwhile, look again
+                size_t half = (left + 1) / 2;
+                send   = ranges[victim].end;
+                sbegin = send - half;
+                ranges[victim].end = sbegin;
+            }
+            std::lock_guard<std::mutex> guard(ranges[self].lock);
+            ranges[self].begin = sbegin;
+            ranges[self].end   = send;
+            return true;
+        }
+    }
+
+    inline void parallel_for(size_t ntasks, unsigned int nthreads, const std::function<void(size_t, unsigned int)> & task)
+    {
+        if (nthreads == 0) nthreads = std::max(1u, std::thread::hardware_concurrency());
+        if (nthreads > ntasks) nthreads = std::max<size_t>(ntasks, 1);
+
+        // Initial static partitioning
+        std::vector<TaskRange> ranges(nthreads);
+        for (unsigned int i = 0; i < nthreads; i++)
+        {
+            ranges[i].begin = ntasks * i / nthreads;
+            ranges[i].end   = ntasks * (i + 1) / nthreads;
+        }
+
+        auto worker = [&](unsigned int self) {
+            size_t itask;
+            while (true)
+            {
+                if (pop_front(ranges[self], itask)) task(itask, self);
+                else if (!steal(ranges, self)) return;
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned int i = 1; i < nthreads; i++)
+            threads.emplace_back(worker, i);
+        worker(0);
+        for (auto & t : threads) t.join();
+    }
+
+} // namespace
+
+#endif